@@ -356,7 +356,7 @@ template <class T> void AVLTree<T>::clear_internal(Node<T> *node)
 		return;
 	clear_internal(node->left);
 	clear_internal(node->right);
-	delete [] node->dat;
+	delete node->dat;
 	delete node;
 }
 
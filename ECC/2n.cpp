@@ -333,56 +333,46 @@ bool lnum::trace(void) const
 // Computes half-trace of a polynom
 lnum lnum::half_trace(void) const
 {
-	lnum res;
 	if (!field) lnumRoutines::op_err(lE_NULLFIELD);
-	lnum traceVec = field->get_trace_vector();
-	const lnum *halfTraceArr = field->get_half_trace_array();
-	int i, j = 0, k, u;
-	unsigned int t;
-	for (i = 0; i <= l; i++)
-	{
-		for (k = 0, t = p.a[i]; t; k++, t >>= 1)
-			if (t & 1)
-			{
-				u = k + j;
-				while (!(u & 1) && u)
-				{
-					if (traceVec[u]) res.set_bit(0);
-					u >>= 1;
-					res.set_bit(u);
-				}
-				if (u) res += halfTraceArr[u >> 1];
-			}
-		j += lbLen;
-	}
+	lnum res(*field);
+	half_trace(res);
 	return res;
 }
 
 // Computes half-trace of a polynom and save result to polynom res
 void lnum::half_trace(lnum &res) const
 {
-	int i, j = 0, k, u;
+	int i, j = 0, k, u, w;
 	unsigned int t;
 	if (!field) lnumRoutines::op_err(lE_NULLFIELD);
-	lnum traceVec = field->get_module();
+	const lnum &traceVec = field->get_trace_vector();
 	const lnum *halfTraceArr = field->get_half_trace_array();
-	res.zero();
+	// Words are xored directly (this is the inner loop of point halving); res may be this polynom.
+	lnum acc(*field);
 	for (i = 0; i <= l; i++)
 	{
 		for (k = 0, t = p.a[i]; t; k++ ,t >>= 1)
 			if (t & 1)
 			{
 				u = k + j;
+				// H(c^2) = H(c) + c + Tr(c)
 				while (!(u & 1) && u)
 				{
-					if (traceVec[u]) res.set_bit(0);
+					if (traceVec[u]) acc.p.a[0] ^= 1;
 					u >>= 1;
-					res.set_bit(u);
+					acc.p.a[u / lbLen] ^= 1u << (u % lbLen);
+				}
+				if (u)
+				{
+					const lnum &h = halfTraceArr[u >> 1];
+					for (w = 0; w <= h.l; w++) acc.p.a[w] ^= h.p.a[w];
 				}
-				if (u) res += halfTraceArr[u >> 1];
 			}
 		j += lbLen;
 	}
+	acc.l = (field->get_deg() - 1) / lbLen;
+	acc.fix_deg();
+	res = acc;
 }
 
 /* Factory methods */
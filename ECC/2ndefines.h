@@ -18,6 +18,17 @@
 // Length of polynoms in unsigned integers
 #define lLen     100
 
+// Maximum number of non-zero bits of a field generator, for which reduction keeps its buffers on stack
+#define lModsLocal 8
+
+/*******************************************/
+/* Quadratic equation solver configuration */
+/*******************************************/
+
+// Number of bits of a polynom handled by one lookup in the quadratic solver table (must divide lbLen).
+// Table holds 2^lSolveBits solutions for every group of lSolveBits bits.
+#define lSolveBits 4
+
 /*****************************************/
 /* Karacuba multiplication configuration */
 /*****************************************/
@@ -42,6 +42,13 @@ gf2n::gf2n(const gf2n &field) : module(field.module), sqrt_x(field.sqrt_x), trac
 	for (i = 0; i <= non_zero_bit_count; i++)
 		non_zero_bits[i] = field.non_zero_bits[i];
 
+	int deg = field.get_deg();
+	int tableSize = (field.solve_table ? ((deg + lSolveBits - 1) / lSolveBits << lSolveBits) * field.solve_words : 0);
+	solve_words = field.solve_words;
+	solve_table = (tableSize ? new unsigned int[tableSize] : 0);
+	for (i = 0; i < tableSize; i++)
+		solve_table[i] = field.solve_table[i];
+
 	loutMode = field.loutMode;
 	ldivMode = field.ldivMode;
 }
@@ -50,6 +57,7 @@ gf2n::~gf2n()
 {
 	delete [] half_trace_array;
 	delete [] non_zero_bits;
+	delete [] solve_table;
 }
 
 /* Internal routines */
@@ -112,6 +120,62 @@ void gf2n::calc_sqrt_x(lnum &sqrt_x)
 	for (i = 1; i < non_zero_bits[non_zero_bit_count]; i++) sqrt_x = lnumOperations::sqr(sqrt_x);
 }
 
+// Calculates quadratic solver table for given degree n.
+// Map a -> Z, where Z * Z + Z = a whenever Tr(a) = 0, is linear, so it is tabulated for every combination of bits within each lSolveBits-bit group of a.
+// For odd n the map is half-trace, otherwise Z = sum of a^(2^i) * (u^(2^(i + 1)) + ... + u^(2^(n - 1))) for some u with Tr(u) = 1.
+// For odd n the root is the one, earlier versions of half-trace returned (they took the bits of H(c^2) = H(c) + c + Tr(c) from the module
+// instead of the trace vector, so Z differed by 1). Points, packed by them, keep their solution bit.
+void gf2n::calc_solve_table(int n)
+{
+	int i, j, k, s, v;
+	int groups = (n + lSolveBits - 1) / lSolveBits;
+	solve_words = (n - 1) / lbLen + 1;
+	solve_table = new unsigned int[(groups << lSolveBits) * solve_words];
+	for (i = 0; i < (groups << lSolveBits) * solve_words; i++)
+		solve_table[i] = 0;
+
+	lnum a(*this), z(*this), u(*this);
+	for (i = 0; i < n; i++)
+	{
+		a.zero();
+		a.set_bit(i);
+		if (n & 1)
+		{
+			a.half_trace(z);
+			for (s = i; s && !(s & 1); s >>= 1)
+				if (module[s] != trace_vector[s]) z.set_bit(0);
+		}
+		else
+		{
+			z.zero();
+			u.zero(); u.set_bit(tr1e);
+			for (j = 1; j < n; j++)
+			{
+				u = lnumOperations::sqr(u);
+				z = lnumOperations::sqr(z);
+				z += u * a;
+				u.set_bit(tr1e);
+			}
+		}
+		unsigned int *row = solve_table + ((i / lSolveBits << lSolveBits) + (1 << i % lSolveBits)) * solve_words;
+		for (j = 0; j <= z.l && j < solve_words; j++)
+			row[j] = z.p.a[j];
+	}
+	// Remaining combinations are sums of single-bit solutions.
+	for (k = 0; k < groups; k++)
+	{
+		unsigned int *group = solve_table + (k << lSolveBits) * solve_words;
+		for (v = 3; v < (1 << lSolveBits); v++)
+		{
+			if (!(v & (v - 1))) continue;
+			const unsigned int *r1 = group + (v & (v - 1)) * solve_words;
+			const unsigned int *r2 = group + (v & -v) * solve_words;
+			for (j = 0; j < solve_words; j++)
+				group[v * solve_words + j] = r1[j] ^ r2[j];
+		}
+	}
+}
+
 // Sets the module and does all the necessary initialization calculations.
 // Polynom module must generate a field.
 // Returns one of the error codes stating the result of operation.
@@ -136,6 +200,7 @@ int gf2n::set_module()
 	calc_trace_vector(module, non_zero_bits[non_zero_bit_count], trace_vector);
 	if (non_zero_bits[non_zero_bit_count] & 1) calc_half_trace_matrix(non_zero_bits[non_zero_bit_count], half_trace_array);
 	calc_sqrt_x(sqrt_x);
+	calc_solve_table(non_zero_bits[non_zero_bit_count]);
 
 	/* Clean up this mess, wtf is this anyway?? */
 	/*MSG_LEN = non_zero_bits[non_zero_bit_count];
@@ -153,6 +218,8 @@ void gf2n::initialize()
 	// must be of length (lLen * lbLen + 1) / 2
 	half_trace_array = new lnum[module.deg() / 2];
 	non_zero_bits = new int[non_zero_bit_count + 1];
+	solve_table = 0;
+	solve_words = 0;
 
 	// Set default settings
 	loutMode = loutBin;
@@ -223,6 +290,18 @@ const lnum *gf2n::get_half_trace_array() const
 	return half_trace_array;
 }
 
+// Returns pointer to quadratic solver table (solutions for every lSolveBits-bit group, get_solve_words() words each).
+const unsigned int *gf2n::get_solve_table() const
+{
+	return solve_table;
+}
+
+// Returns number of words per solution in quadratic solver table.
+int gf2n::get_solve_words() const
+{
+	return solve_words;
+}
+
 /* Setter methods */
 
 void gf2n::set_output_mode(int output_mode)
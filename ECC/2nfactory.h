@@ -31,6 +31,8 @@ public:
 	const lnum &get_trace_vector() const;
 	const lnum &get_sqrt_x() const;
 	const lnum *get_half_trace_array() const;
+	const unsigned int *get_solve_table() const;
+	int get_solve_words() const;
 
 	/* Setter methods */
 	void set_output_mode(int output_mode);
@@ -48,6 +50,7 @@ private:
 	void calc_trace_vector(const lnum &m, int n, lnum &res);
 	void calc_half_trace_matrix(int n, lnum Th[]);
 	void calc_sqrt_x(lnum &sqrt_x);
+	void calc_solve_table(int n);
 	int set_module();
 	void initialize();
 
@@ -65,6 +68,8 @@ private:
 	lnum trace_vector;                             // Trace vector
 	lnum *half_trace_array;                        // Half-trace polynom array
 	lnum sqrt_x;                                   // Square root of polynom x
+	unsigned int *solve_table;                     // Solutions of Z * Z + Z = a for every lSolveBits-bit group of a
+	int solve_words;                               // Words per solution in solve_table
 };
 
 #endif
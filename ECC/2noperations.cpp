@@ -1,6 +1,7 @@
 #include "2noperations.h"
 #include "2n.h"
 #include "2nfactory.h"
+#include "prng.h"
 
 namespace lnumRoutines
 {
@@ -69,6 +70,17 @@ namespace lnumRoutines
 		return r;
 	}
 
+	// Packs even bits of integer a into its lower 16 bits.
+	unsigned int even_bits_int(unsigned int a)
+	{
+		a &= 0x55555555;
+		a = (a | (a >> 1)) & 0x33333333;
+		a = (a | (a >> 2)) & 0x0F0F0F0F;
+		a = (a | (a >> 4)) & 0x00FF00FF;
+		a = (a | (a >> 8)) & 0x0000FFFF;
+		return a;
+	}
+
 	// Returns a product of 2 polynoms a and b of degree no more than 7. Uses shifting multiplication method.
 	unsigned short shift_mul(unsigned char a, unsigned char b)
 	{
@@ -205,22 +217,13 @@ int lnumOperations::cmp(const lnum &a, const lnum &b)
 // Generates a random polynom parts upto index l.
 void lnumOperations::lrandom(lnum &a, int l)
 {
-	int i, t;
+	int i;
 	if (l < 0) return;
+	prng &generator = prng::global();
 	a.fill_zero(0, a.l + 1);
 	a.l = l;
 	for (i = 0; i <= l; i++)
-	{
-		a.p.a2[2 * i] = rand();
-		t = rand() % 3;
-		if (t == 1) a.p.a2[2 * i] *= 2;
-		else if (t == 2) a.p.a2[2 * i] = a.p.a2[2 * i] * 2 + 1;
-		/************************************************/
-		a.p.a2[2 * i + 1] = rand();
-		t = rand() % 3;
-		if (t == 1) a.p.a2[2 * i + 1] *= 2;
-		else if (t == 2) a.p.a2[2 * i + 1] = a.p.a2[2 * i + 1] * 2 + 1;
-	}
+		a.p.a[i] = generator.next();
 	a.fix_deg();
 }
 
@@ -433,6 +436,15 @@ lnum lnumOperations::sqr(const lnum &a)
 	return res;
 }
 
+// Returns square root of polynom a.
+lnum lnumOperations::sqrt(const lnum &a)
+{
+	if (!a.field) lnumRoutines::op_err(lE_NULLFIELD);
+	lnum res(*a.field);
+	sqrt(a, res);
+	return res;
+}
+
 // Shifts polynom a count bits left and saves result to polynom res.
 // Returns one of the error codes stating the result of operation.
 int lnumOperations::shl(const lnum &a, int count, lnum &res)
@@ -519,26 +531,23 @@ int lnumOperations::scalar(lnum &a, const lnum &b)
 }
 
 // Calculates square root of polynom a and saves result to polynom res.
+// For a = e(x^2) + x * o(x^2), where e and o collect even and odd bits of a, square root is e(x) + sqrt(x) * o(x).
 int lnumOperations::sqrt(const lnum &a, lnum &res)
 {
 	if (!a.field) return lE_NULLFIELD;
 	if (a.field != res.field) return lE_DIFFFIELD;
-	int i;
-	res.zero();
-	lnum t(*a.field);
-	for (i = 0; i <= a.deg(); i++)
-		if (a[i])
-		{
-			if (i & 1)
-			{
-				shl(a.field->get_sqrt_x(), i >> 1, t);
-				res += t;
-			}
-			else
-			{
-				res.set_bit(i >> 1);
-			}
-		}
+	int i, shift;
+	lnum e(*a.field), o(*a.field);
+	for (i = 0; i <= a.l; i++)
+	{
+		shift = (i & 1) * (lbLen / 2);
+		e.p.a[i >> 1] |= lnumRoutines::even_bits_int(a.p.a[i]) << shift;
+		o.p.a[i >> 1] |= lnumRoutines::even_bits_int(a.p.a[i] >> 1) << shift;
+	}
+	e.l = o.l = a.l >> 1;
+	e.fix_deg();
+	o.fix_deg();
+	res = e + o * a.field->get_sqrt_x();
 	return lE_OK;
 }
 
@@ -615,9 +624,11 @@ int lnumOperations::mods(const lnum &a, const lnum &b, const int L[], int lN, ln
 	unsigned int w;
 
 	// memory allocation is done here to adapt the procedure for parallel execution
+	// (sparse modules, e.g. trinomials and pentanomials, use stack buffers - mods runs after every multiplication)
+	int modslLocal[lModsLocal], modstLocal[lModsLocal];
 	i = a.field->get_non_zero_bit_count();
-	int *modsl = new int[i];
-	int *modst = new int[i];
+	int *modsl = i <= lModsLocal ? modslLocal : new int[i];
+	int *modst = i <= lModsLocal ? modstLocal : new int[i];
 
 	for (i = 0; i < lN; i++)
 	{
@@ -653,8 +664,11 @@ int lnumOperations::mods(const lnum &a, const lnum &b, const int L[], int lN, ln
 	}
 	res.fix_deg();
 
-	delete [] modsl;
-	delete [] modst;
+	if (modsl != modslLocal)
+	{
+		delete [] modsl;
+		delete [] modst;
+	}
 
 	return lE_OK;
 }
@@ -744,28 +758,28 @@ int lnumOperations::bit_neg(const lnum &a, lnum &res)
 
 // Solves equation Z * Z + Z = a, returns true if successful, otherwise - false.
 // Solution is returned through polynom res, second solution is polynom res + 1.
+// Solution is summed from fields quadratic solver table, one row per lSolveBits-bit group of a.
 int lnumOperations::solve_quadratic_red(const lnum &a, lnum &res)
 {
 	if (!a.field) return lE_NULLFIELD;
 	if (a.field != res.field) return lE_DIFFFIELD;
 	if (a.trace()) return lE_NOSOLUTION;
 
-	int deg = a.field->get_deg();
-	if (deg & 1) a.half_trace(res);
-	else
-	{
-		lnum u(*a.field);
-		res.zero();
-		u.zero(); u.set_bit(a.field->get_trace_one_element());
-		int i;
-		for (i = 1; i < deg; i++)
-		{
-			u = sqr(u);
-			res = sqr(res);
-			res += u * a;
-			u.set_bit(a.field->get_trace_one_element());
-		}
-	}
+	int i, k, w;
+	unsigned int t;
+	const unsigned int *table = a.field->get_solve_table();
+	int words = a.field->get_solve_words();
+	lnum acc(*a.field);
+	for (i = 0; i <= a.l; i++)
+		for (k = i * (lbLen / lSolveBits), t = a.p.a[i]; t; k++, t >>= lSolveBits)
+			if (t & ((1 << lSolveBits) - 1))
+			{
+				const unsigned int *row = table + ((k << lSolveBits) + (t & ((1 << lSolveBits) - 1))) * words;
+				for (w = 0; w < words; w++) acc.p.a[w] ^= row[w];
+			}
+	acc.l = words - 1;
+	acc.fix_deg();
+	res = acc;
 	return lE_OK;
 }
 
@@ -794,6 +808,175 @@ int lnumOperations::solve_quadratic(const lnum &b, const lnum &c, lnum &res, lnu
 	return lE_OK;
 }
 
+// Computes a ^ (2 ^ k) (Frobenius map applied k times) and saves result to polynom res.
+// Returns one of the error codes stating the result of operation.
+int lnumOperations::frobenius(const lnum &a, int k, lnum &res)
+{
+	if (!a.field) return lE_NULLFIELD;
+	if (a.field != res.field) return lE_DIFFFIELD;
+	lnum t(*a.field);
+	res = a;
+	for (int i = 0; i < k; i++)
+	{
+		sqr(res, t);
+		mod(t, res);
+	}
+	return lE_OK;
+}
+
+// Finds the least of conjugates a ^ (2 ^ i) (0 <= i < deg) and saves it to polynom res, and i - to power.
+// Returns one of the error codes stating the result of operation.
+int lnumOperations::least_conjugate(const lnum &a, lnum &res, int &power)
+{
+	if (!a.field) return lE_NULLFIELD;
+	if (a.field != res.field) return lE_DIFFFIELD;
+	int i, m = a.field->get_deg();
+	lnum x(a), t(*a.field);
+	res = a;
+	power = 0;
+	for (i = 1; i < m; i++)
+	{
+		sqr(x, t);
+		mod(t, x);
+		if (cmp(x, res) < 0)
+		{
+			res = x;
+			power = i;
+		}
+	}
+	return lE_OK;
+}
+
+/* Batch algorithms */
+
+// Inverts count polynoms a with a single field division (Montgomery's trick), saves results to res.
+// Zero polynoms are skipped (their results are zero). Array res may be array a.
+int lnumOperations::inv_n(const lnum *a, int count, lnum *res)
+{
+	int i;
+	if (count <= 0) return lE_OK;
+	if (!a[0].field) return lE_NULLFIELD;
+	const gf2n &field = *a[0].field;
+	for (i = 0; i < count; i++)
+	{
+		if (a[i].field != &field) return lE_DIFFFIELD;
+		if (res[i].field != &field) return lE_DIFFFIELD;
+	}
+
+	lnum *prefix = new lnum[count];
+	lnum acc(field), t(field);
+	acc.one();
+	// prefix[i] is product of all non-zero polynoms among a[0..i - 1].
+	for (i = 0; i < count; i++)
+	{
+		prefix[i] = acc;
+		if (!a[i].is_zero()) acc = acc * a[i];
+	}
+	t.one();
+	acc = t / acc;
+	// acc is inverse of product of non-zero polynoms among a[0..i].
+	for (i = count - 1; i >= 0; i--)
+	{
+		if (a[i].is_zero())
+		{
+			res[i].zero();
+			continue;
+		}
+		t = acc * prefix[i];
+		acc = acc * a[i];
+		res[i] = t;
+	}
+	delete [] prefix;
+	return lE_OK;
+}
+
+// Solves count equations Z * Z + Z = a[i], saves solutions to res (as solve_quadratic_red does).
+// Table rows are walked in the outer loop and equations in the inner one, so each row is used for the whole batch while it is in cache.
+// Returns lE_NOSOLUTION if any equation has no solution (other results are still computed). Array res may be array a.
+int lnumOperations::solve_quadratic_red_n(const lnum *a, int count, lnum *res)
+{
+	int i, j, k, w;
+	unsigned int v;
+	if (count <= 0) return lE_OK;
+	if (!a[0].field) return lE_NULLFIELD;
+	const gf2n &field = *a[0].field;
+	for (i = 0; i < count; i++)
+	{
+		if (a[i].field != &field) return lE_DIFFFIELD;
+		if (res[i].field != &field) return lE_DIFFFIELD;
+	}
+
+	int result = lE_OK;
+	const unsigned int *table = field.get_solve_table();
+	int words = field.get_solve_words();
+	int groups = (field.get_deg() + lSolveBits - 1) / lSolveBits;
+	unsigned int *acc = new unsigned int[count * words];
+	for (i = 0; i < count * words; i++) acc[i] = 0;
+	for (k = 0; k < groups; k++)
+	{
+		i = k / (lbLen / lSolveBits);
+		int shift = (k % (lbLen / lSolveBits)) * lSolveBits;
+		for (j = 0; j < count; j++)
+		{
+			if (i > a[j].l) continue;
+			v = (a[j].p.a[i] >> shift) & ((1 << lSolveBits) - 1);
+			if (!v) continue;
+			const unsigned int *row = table + ((k << lSolveBits) + v) * words;
+			unsigned int *dst = acc + j * words;
+			for (w = 0; w < words; w++) dst[w] ^= row[w];
+		}
+	}
+	for (j = 0; j < count; j++)
+	{
+		if (a[j].trace()) result = lE_NOSOLUTION;
+		res[j].zero();
+		for (w = 0; w < words; w++) res[j].p.a[w] = acc[j * words + w];
+		res[j].l = words - 1;
+		res[j].fix_deg();
+	}
+	delete [] acc;
+	return result;
+}
+
+// Solves count equations Z * Z + b[i] * Z = c[i], saves solutions to res and res2 (in the same order solve_quadratic does).
+// All divisions by b[i] share one field division. Returns lE_NOSOLUTION if any equation has no solution (other results are still computed).
+int lnumOperations::solve_quadratic_n(const lnum *b, const lnum *c, int count, lnum *res, lnum *res2)
+{
+	int i;
+	if (count <= 0) return lE_OK;
+	if (!b[0].field) return lE_NULLFIELD;
+	const gf2n &field = *b[0].field;
+	for (i = 0; i < count; i++)
+	{
+		if (b[i].field != &field || c[i].field != &field) return lE_DIFFFIELD;
+		if (res[i].field != &field || res2[i].field != &field) return lE_DIFFFIELD;
+	}
+
+	int r;
+	lnum *cc = new lnum[count];
+	for (i = 0; i < count; i++) cc[i] = b[i];
+	if (r = inv_n(cc, count, cc))
+	{
+		delete [] cc;
+		return r;
+	}
+	for (i = 0; i < count; i++) cc[i] = c[i] * sqr(cc[i]);
+	int result = solve_quadratic_red_n(cc, count, cc);
+	for (i = 0; i < count; i++)
+	{
+		if (b[i].is_zero())
+		{
+			sqrt(c[i], res[i]);
+			res2[i].zero();
+			continue;
+		}
+		res[i] = cc[i] * b[i];
+		res2[i] = res[i] + b[i];
+	}
+	delete [] cc;
+	return result;
+}
+
 /* Modification routines */
 
 // Changes count bits of polynom a to count bits from integer what.
@@ -820,3 +1003,21 @@ void lnumOperations::modify(lnum &a, int pos, unsigned int what, int count)
 	if (j % lbLen) a.l++;
 	a.fix_deg();
 }
+
+// Swaps polynoms a and b (of the same field) if swap is true.
+// Uses masks instead of branches and touches all words of the field, so the work done does not depend on swap.
+void lnumOperations::cswap(lnum &a, lnum &b, bool swap)
+{
+	int i, words = lLen;
+	unsigned int mask = 0u - (unsigned int)swap, t;
+	if (a.field) words = min(lLen, a.field->get_deg() / lbLen + 1);
+	for (i = 0; i < words; i++)
+	{
+		t = (a.p.a[i] ^ b.p.a[i]) & mask;
+		a.p.a[i] ^= t;
+		b.p.a[i] ^= t;
+	}
+	int tl = (a.l ^ b.l) & (int)mask;
+	a.l ^= tl;
+	b.l ^= tl;
+}
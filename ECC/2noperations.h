@@ -16,6 +16,7 @@ namespace lnumRoutines
 	void lpBin_int(std::ostream& s, unsigned int a);
 	void lpHex_int(std::ostream& s, unsigned int a);
 	unsigned char bitcnt_int(unsigned int a);
+	unsigned int even_bits_int(unsigned int a);
 	unsigned short shift_mul(unsigned char a, unsigned char b);
 	char lHp(unsigned int a);
 	void int_mul(unsigned int a, unsigned int b, unsigned int &r1, unsigned int &r2);
@@ -57,6 +58,13 @@ public:
 	/* Alrorithms */
 	static int solve_quadratic_red(const lnum &a, lnum &res);
 	static int solve_quadratic(const lnum &b, const lnum &c, lnum &res, lnum &res2);
+	static int frobenius(const lnum &a, int k, lnum &res);
+	static int least_conjugate(const lnum &a, lnum &res, int &power);
+
+	/* Batch algorithms */
+	static int inv_n(const lnum *a, int count, lnum *res);
+	static int solve_quadratic_red_n(const lnum *a, int count, lnum *res);
+	static int solve_quadratic_n(const lnum *b, const lnum *c, int count, lnum *res, lnum *res2);
 
 	/* Conditions */
 	static int belong_to_same_nonzero_field(const lnum &a, const lnum &b);
@@ -67,9 +75,11 @@ public:
 
 	/* Modification routines */
 	static void modify(lnum &a, int pos, unsigned int what, int count);
+	static void cswap(lnum &a, lnum &b, bool swap);
 
 	/* Operation routines */
 	static lnum sqr(const lnum &a);
+	static lnum sqrt(const lnum &a);
 
 	friend class lnum;
 	friend class gf2n;
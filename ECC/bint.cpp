@@ -1,11 +1,13 @@
 #include "bint.h"
 #include "bintoperations.h"
+#include "prng.h"
 
 /* Constructors */
 
 // Creates a new instance of bint class with zero big integer.
 bint::bint(void)
 {
+	init_storage();
 	zero();
 }
 
@@ -13,6 +15,7 @@ bint::bint(void)
 bint::bint(int b)
 {
 	//bint t;
+	init_storage();
 	if (b == 0)
 	{
 		zero();
@@ -38,6 +41,7 @@ bint::bint(int b)
 bint::bint(char *str)
 {
 	int len, i, t, h, s;
+	init_storage();
 	len = strlen(str);
 	if (!len)
 	{
@@ -54,8 +58,21 @@ bint::bint(char *str)
 		s++;
 	} else sgn = 1;
 	if (str[0] == '+') s++;
+	// Hexademical representation (x1F or 0x1F) is converted with divide and conquer.
+	if (str[s] == bHexChar || (str[s] == '0' && str[s + 1] == bHexChar))
+	{
+		s += (str[s] == '0') ? 2 : 1;
+		for (len = 0; bintRoutines::hex_value(str[s + len]) >= 0; len++);
+		short sign = sgn;
+		if (i = bintOperations::from_hex(str + s, len, *this)) bintRoutines::op_err(i);
+		sgn = sign;
+		fix_zero();
+		return;
+	}
 	while (s < len && str[s] == '0') s++;
 	while (len && !(str[len - 1] >= '0' && str[len - 1] <= '9')) len--;
+	i = bLen + 1 - ((len - s) / bModLen + 1);
+	reserve(i > 0 ? i : 0);
 	for (i = len - 1;i >= s; i--)
 	{
 		if (!isdigit(str[i])) break;
@@ -85,8 +102,10 @@ bint::bint(char *str)
 bint::bint(const int *integers, int length, int sign)
 {
 	int i;
+	init_storage();
 	if (length > bLen + 1) bintRoutines::op_err(bE_OVERFLOW);
 	if (sign != -1 && sign != +1) bintRoutines::op_err(bE_OVERFLOW);
+	reserve(bLen + 1 - length);
 	for (i = 0; i < length; i++)
 	{
 		if (integers[i] < 0 || integers[i] >= bMod) bintRoutines::op_err(bE_OVERFLOW);
@@ -98,8 +117,48 @@ bint::bint(const int *integers, int length, int sign)
 	fix_zero();
 }
 
+// Creates a copy of big integer b.
+bint::bint(const bint &b)
+{
+	init_storage();
+	*this = b;
+}
+
+/* Destructors */
+
+// Frees digit groups stored on heap.
+bint::~bint()
+{
+	if (a.data != small)
+		delete [] a.data;
+}
+
 /* Private methods */
 
+// Sets up inline storage for the least significant digit groups.
+void bint::init_storage(void)
+{
+	a.data = small;
+	a.low = bLen + 1 - bSmallLen;
+	l = bLen + 1;
+}
+
+// Makes digit groups [low, bLen] available. Used digit groups [l, bLen] are preserved.
+void bint::reserve(int low)
+{
+	if (low >= a.low) return;
+	int i;
+	int newLow = bLen + 1 - 2 * (bLen + 1 - a.low);
+	if (newLow > low) newLow = low;
+	if (newLow < 0) newLow = 0;
+	int *data = new int[bLen + 1 - newLow];
+	for (i = (l > a.low ? l : a.low); i <= bLen; i++) data[i - newLow] = a[i];
+	if (a.data != small)
+		delete [] a.data;
+	a.data = data;
+	a.low = newLow;
+}
+
 // Fixes length of a big intger (decrements it as needed).
 void bint::fix_len(void)
 {
@@ -112,12 +171,13 @@ void bint::fix_zero(void)
 	if (is_zero() && sgn < 0) sgn = 1;
 }
 
-// Fills the big integer with zeros.
-void bint::fill_zero(void)
+// Fills the big integer digit groups [low, bLen] with zeros.
+void bint::fill_zero(int low)
 {
 	int i;
-	for (i = 0; i <= bLen; i++) a[i] = 0;
-	l = 0;
+	reserve(low);
+	for (i = low; i <= bLen; i++) a[i] = 0;
+	l = low;
 }
 
 // Reverses the big integer. Where the hell do I use this?!
@@ -186,9 +246,41 @@ void bint::one(void)
 // Generates a random big integer.
 void bint::random(void)
 {
-    int i;
-    l = 0;
-    for (i = 0; i <= bLen; i++) a[i] = rand() % bMod;
+	random(prng::global());
+}
+
+// Generates a random big integer using a given generator.
+void bint::random(prng &generator)
+{
+	int i;
+	reserve(0);
+	l = 0;
+	sgn = 1;
+	for (i = 0; i <= bLen; i++) a[i] = generator.next_below(bMod);
+	fix_len();
+}
+
+// Generates a uniformly distributed random big integer from [0, n).
+void bint::random_mod(const bint &n)
+{
+	random_mod(n, prng::global());
+}
+
+// Generates a uniformly distributed random big integer from [0, n) using a given generator.
+// Only digits up to the leading digit of n are generated and numbers not less than n are rejected (probability of rejection is below 1/2).
+void bint::random_mod(const bint &n, prng &generator)
+{
+	int i;
+	if (n.is_zero() || n.is_less_zero()) bintRoutines::op_err(bE_DIVZERO);
+	reserve(n.l);
+	do
+	{
+		l = n.l;
+		sgn = 1;
+		a[l] = generator.next_below(n.a[n.l] + 1);
+		for (i = l + 1; i <= bLen; i++) a[i] = generator.next_below(bMod);
+		fix_len();
+	} while (*this >= n);
 }
 
 /* Accessor methods */
@@ -211,16 +303,17 @@ int bint::get_length() const
 	return l;
 }
 
-// Returns a pointer to an array of bit integers digit groups.
+// Returns a pointer to used digit groups of the big integer (starting from the most significant one).
 const int *bint::get_ints(void) const
 {
-	return a;
+	return a.data + (l - a.low);
 }
 
 // Returns i-th digit group of the big integer.
 int bint::operator[] (int index) const
 {
 	if (index > bLen) bintRoutines::op_err(bE_ACCVIOLATION);
+	if (index < l) return 0;
 	return a[index];
 }
 
@@ -230,6 +323,8 @@ int bint::operator[] (int index) const
 void bint::operator= (const bint &b)
 {
 	int i;
+	if (this == &b) return;
+	reserve(b.l);
 	sgn = b.sgn;
 	l = b.l;
 	for (i = l; i <= bLen; i++) a[i] = b.a[i];
@@ -407,15 +502,6 @@ bint bint::operator/ (int b) const
 
 std::ostream& operator<< (std::ostream& s, const bint& a)
 {
-	int i, j, l = a.get_length();
-	char tmp[(bModLen + 1) * (bModLen + 1)];
-	if (l == -1) s << "-";
-	for (i = a.get_length(); i <= bLen; i++)
-	{
-		sprintf(tmp, "%i", a[i]);
-		j = strlen(tmp);
-		for (;j < bModLen && i > l; j++) s << 0;
-		s << tmp;
-	}
+	bintOperations::bpDec(s, a);
 	return s;
 }
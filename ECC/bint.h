@@ -7,6 +7,17 @@
 
 /* Need some classes */
 class bint;
+class prng;
+
+// Storage of big integer digit groups. Only groups [low, bLen] are stored, but they are indexed as in a full-length array.
+struct bdigits
+{
+	int &operator[] (int index) { return data[index - low]; }
+	int operator[] (int index) const { return data[index - low]; }
+
+	int *data;
+	int low;
+};
 
 class bint
 {
@@ -16,6 +27,10 @@ public:
 	bint(int b);
 	bint(char *str);
 	bint(const int *integers, int length, int sign);
+	bint(const bint &b);
+
+	/* Destructors */
+	~bint();
 
 	/* Help methods */
 	bool is_zero(void) const;
@@ -28,6 +43,9 @@ public:
 	void zero(void);
 	void one(void);
 	void random(void);
+	void random(prng &generator);
+	void random_mod(const bint &n);
+	void random_mod(const bint &n, prng &generator);
 
 	/* Accessor methods */
 	unsigned int low_int(void) const;
@@ -56,12 +74,15 @@ public:
 
 private:
 	/* Private methods */
+	void init_storage(void);
+	void reserve(int low);
 	void fix_len(void);
 	void fix_zero(void);
-	void fill_zero(void);
+	void fill_zero(int low = 0);
 	void rev(void);
 
-	int a[bLen + 1];
+	bdigits a;
+	int small[bSmallLen];
 	short sgn;
 	int l;
 
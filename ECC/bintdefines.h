@@ -14,6 +14,21 @@
 // Number of digits to store in one array element.
 #define bModLen  4
 
+// Number of digit groups stored inside big integer object. Longer integers keep thier digit groups on heap.
+#define bSmallLen 8
+
+// Leading charter for hexademical input.
+#define bHexChar  'x'
+
+// Number of bits in a word used by binary radix conversion (bMod * 2^bWordBits must fit into int).
+#define bWordBits 16
+
+// Number of cached powers 2^(bWordBits * 2^i) used by binary radix conversion (they must not overflow).
+#define bPowCount 8
+
+// Maximum number of bWordBits-bit words in a big integer (log2(10) < 10 / 3).
+#define bWordCount ((bLen + 1) * bModLen * 10 / (3 * bWordBits) + 1)
+
 /*************************************/
 /* Enum-like constants configuration */
 /*************************************/
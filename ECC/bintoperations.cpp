@@ -45,6 +45,15 @@ namespace bintRoutines
 		if (a > 0) return +1;
 		return 0;
 	}
+
+	// Returns value of hexademical digit c or -1, if c is not a hexademical digit.
+	int hex_value(char c)
+	{
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
 }
 
 /* Help routines */
@@ -89,6 +98,7 @@ int bintOperations::add(const bint &a, const bint &b, bint &res)
 	}
 	int l, m, r, t;
 	m = max(a.l, b.l);
+	res.reserve(max(min(a.l, b.l) - 1, 0));
 	r = 0;
 	for (l = bLen; l >= m; l--)
 	{
@@ -143,6 +153,7 @@ int bintOperations::inc(bint &a, const bint &b)
 	}
 	int l, m, r, t;
 	m = max(a.l, b.l);
+	a.reserve(max(min(a.l, b.l) - 1, 0));
 	r = 0;
 	for (l = bLen; l >= m; l--)
 	{
@@ -194,6 +205,7 @@ int bintOperations::sub(const bint &a, const bint &b, bint &res)
 		return bE_OK;
 	}
 	int i, r, t;
+	res.reserve(min(a.l, b.l));
 	r = 0;
 	if (cmpl(a, b) > 0)
 	{
@@ -257,6 +269,7 @@ int bintOperations::dec(bint &a, const bint &b)
 {
 	if (b.is_zero()) return bE_OK;
 	int i, r, t;
+	a.reserve(min(a.l, b.l));
 	r = 0;
 	if (cmpl(a, b) > 0)
 	{
@@ -331,7 +344,7 @@ int bintOperations::mul(const bint &a, const bint &b, bint &res)
 		res = a;
 		return bE_OK;
 	}
-	res.fill_zero();
+	res.fill_zero(max(a.l - bLen + b.l - 1 - 3, 0));
 	int l, j, r, t, z;
 	r = 0;
 	for (l = bLen; l >= a.l; l--)
@@ -392,7 +405,7 @@ int bintOperations::mul_short(const bint &a, int c, bint &res)
 		res = a;
 		return bE_OK;
 	}
-	res.fill_zero();
+	res.fill_zero(max(a.l - 1, 0));
 	int l, r, t;
 	r = 0;
 	for (l = bLen; l >= a.l; l--)
@@ -529,13 +542,23 @@ int bintOperations::div(const bint &d, const bint &b, bint &res)
 		}
 		res.a[res.l] = l;
 		if (!res.l) return bE_OVERFLOW;
+		res.reserve(res.l - 1);
 		res.a[--res.l] = 0;
 		mul(b, l, t);
 		if (l = sub_sub(a, s, t, bLen)) return l;
 		s++;
 	}
-	res.fix_len();
+	// Remainder is less than b, so the rest of quotient digits are zeros.
+	for (; s <= bLen; s++)
+	{
+		if (!res.l) return bE_OVERFLOW;
+		res.reserve(res.l - 1);
+		res.a[--res.l] = 0;
+	}
+	// Last digit is unused.
+	res.l++;
 	res.rev();
+	res.fix_len();
 	return bE_OK;
 }
 
@@ -549,6 +572,7 @@ int bintOperations::div_short(const bint &a, int b, bint &res)
 		res = a;
 		return bE_OK;
 	}
+	res.reserve(a.l);
 	res.l = a.l;
 	int i, r;
 	r = 0;
@@ -633,6 +657,21 @@ int bintOperations::sub_sub(bint &a, int af, const bint &b, int bf)
 	return bE_OK;
 }
 
+// Internal routine. Divides big integer a by positive integer b (b * bMod must fit into int) in place and returns the remainder.
+int bintOperations::div_short_rem(bint &a, int b)
+{
+	int i, r;
+	r = 0;
+	for (i = a.l; i <= bLen; i++)
+	{
+		r = r * bMod + a.a[i];
+		a.a[i] = r / b;
+		r %= b;
+	}
+	a.fix_len();
+	return r;
+}
+
 // Calucaltes a^n and saves result in big integer res.
 int bintOperations::pow(const bint &a, int n, bint &res)
 {
@@ -693,3 +732,118 @@ int bintOperations::pow(const bint &a, int n, bint &res)
 	if (!u.is_one()) return bE_NOINVERSE;
 	return bE_OK;
 }*/
+
+/* Radix conversion routines */
+
+// Returns 2^(bWordBits * 2^i). Powers are calculated once, when they are requested for the first time.
+const bint &bintOperations::word_power(int i)
+{
+	static bint powers[bPowCount];
+	static int count = 0;
+	int r;
+	if (i >= bPowCount) bintRoutines::op_err(bE_OVERFLOW);
+	while (count <= i)
+	{
+		if (count == 0) powers[0] = bint(1 << bWordBits);
+		else if (r = mul(powers[count - 1], powers[count - 1], powers[count])) bintRoutines::op_err(r);
+		count++;
+	}
+	return powers[i];
+}
+
+// Converts count bWordBits-bit words (least significant first) to big integer res.
+// Divide and conquer: the words are split at the greatest power of two h below count, so that res = high * 2^(bWordBits * h) + low,
+// and both halves are converted recursively. Every level uses one multiplication by a cached power instead of count short steps.
+int bintOperations::from_words(const unsigned int *words, int count, bint &res)
+{
+	if (count <= 1)
+	{
+		res = bint(count == 1 ? (int)words[0] : 0);
+		return bE_OK;
+	}
+	int i, h, r;
+	for (i = 0, h = 1; 2 * h < count; i++) h *= 2;
+	bint high, low;
+	if (r = from_words(words + h, count - h, high)) return r;
+	if (r = from_words(words, h, low)) return r;
+	if (high.is_zero())
+	{
+		res = low;
+		return bE_OK;
+	}
+	if (r = mul(high, word_power(i), res)) return r;
+	return inc(res, low);
+}
+
+// Converts string str of len hexademical digits (most significant first) to a non-negative big integer res.
+int bintOperations::from_hex(const char *str, int len, bint &res)
+{
+	int digitsPerWord = bWordBits / 4;
+	int count = (len + digitsPerWord - 1) / digitsPerWord;
+	int i, j, r;
+	unsigned int *words = new unsigned int[count > 0 ? count : 1];
+	for (i = 0; i < count; i++)
+	{
+		words[i] = 0;
+		for (j = digitsPerWord - 1; j >= 0; j--)
+		{
+			int pos = len - 1 - i * digitsPerWord - j;
+			if (pos >= 0) words[i] = (words[i] << 4) | bintRoutines::hex_value(str[pos]);
+		}
+	}
+	r = from_words(words, count, res);
+	delete [] words;
+	res.sgn = 1;
+	res.fix_len();
+	return r;
+}
+
+// Converts absolute value of big integer a to bWordBits-bit words (least significant first).
+// Array words must have room for bWordCount words, count is set to the number of significant words (zero for zero).
+int bintOperations::to_words(const bint &a, unsigned int *words, int &count)
+{
+	bint t;
+	t = a;
+	count = 0;
+	while (!t.is_zero())
+		words[count++] = div_short_rem(t, 1 << bWordBits);
+	return bE_OK;
+}
+
+/* Printing routines */
+
+// Outputs big integer a to stream s in decimal form.
+// Digit groups are written to a buffer, which is sent to the stream at once.
+void bintOperations::bpDec(std::ostream &s, const bint &a)
+{
+	int i, j, k, t;
+	char *buffer = new char[(bLen + 1 - a.l) * bModLen + 2];
+	k = 0;
+	if (a.sgn < 0 && !a.is_zero()) buffer[k++] = '-';
+	for (i = a.l; i <= bLen; i++)
+	{
+		t = a.a[i];
+		if (i == a.l)
+		{
+			char tmp[bModLen + 1];
+			j = 0;
+			do
+			{
+				tmp[j++] = (char)('0' + t % 10);
+				t /= 10;
+			} while (t > 0);
+			while (j > 0) buffer[k++] = tmp[--j];
+		}
+		else
+		{
+			for (j = bModLen - 1; j >= 0; j--)
+			{
+				buffer[k + j] = (char)('0' + t % 10);
+				t /= 10;
+			}
+			k += bModLen;
+		}
+	}
+	s.write(buffer, k);
+	delete [] buffer;
+}
@@ -1,6 +1,7 @@
 #ifndef _BINTOPERATIONS_H
 #define _BINTOPERATIONS_H
 
+#include <ostream>
 #include "bintdefines.h"
 
 /* Need some classes */
@@ -12,6 +13,7 @@ namespace bintRoutines
 	void op_err(int err);
 	void swap(int &a, int &b);
 	int signum(int a);
+	int hex_value(char c);
 }
 
 class bintOperations
@@ -38,12 +40,24 @@ private:
 	static int div_short(const bint &a, int b, bint &res);
 	static int sub_cmp(const bint &a, int af, const bint &b, int bf);
 	static int sub_sub(bint &a, int af, const bint &b, int bf);
+	static int div_short_rem(bint &a, int b);
 	//static int inv_ring(const bint &a, const bint &m, bint &d2);
 
+	/* Radix conversion routines */
+	static const bint &word_power(int i);
+	static int from_words(const unsigned int *words, int count, bint &res);
+	static int from_hex(const char *str, int len, bint &res);
+
 public:
 	static int pow(const bint &a, int n, bint &res);
 	static int inv(const bint &a, const bint &b, bint &res);
 
+	/* Radix conversion routines */
+	static int to_words(const bint &a, unsigned int *words, int &count);
+
+	/* Printing routines */
+	static void bpDec(std::ostream &s, const bint &a);
+
 	friend class bint;
 };
 
@@ -0,0 +1,159 @@
+#include "cpoint.h"
+#include "epoint.h"
+#include "ecurve.h"
+#include "2nfactory.h"
+#include "2n.h"
+#include <cstring>
+
+/* Helper methods */
+
+// Returns number of significant words of a compact point over field field (bits 0..deg).
+int cpoint::words(const gf2n &field)
+{
+	return field.get_deg() / lbLen + 1;
+}
+
+// Returns size (in bytes) of a compact point record over field field.
+int cpoint::bytes(const gf2n &field)
+{
+	return words(field) * (lbLen / lbByte);
+}
+
+// Returns true if points over field field can be stored in a compact point.
+bool cpoint::fits(const gf2n &field)
+{
+	return words(field) <= pCompactLen;
+}
+
+// Returns hash value of the point (FNV-1a over its words).
+unsigned int cpoint::hash(void) const
+{
+	int i;
+	unsigned int h = 2166136261u;
+	for (i = 0; i < pCompactLen; i++)
+		h = (h ^ w[i]) * 16777619u;
+	return h;
+}
+
+/* Conversion methods */
+
+// Compresses elliptic point p into this compact point.
+// Returns error code, indicating result of the operation.
+int cpoint::from_epoint(const epoint &p)
+{
+	const gf2n &field = p.get_curve().get_field();
+	if (!fits(field)) return pE_PACKERROR;
+	lnum x(field);
+	int res = p.pack(x);
+	if (res != pE_OK) return res;
+	int n = words(field);
+	memcpy(w, x.to_int(), n * sizeof(unsigned int));
+	memset(w + n, 0, (pCompactLen - n) * sizeof(unsigned int));
+	return pE_OK;
+}
+
+// Decompresses this compact point into point res of curve curve.
+// Returns error code, indicating result of the operation.
+int cpoint::to_epoint(const ecurve &curve, epoint &res) const
+{
+	const gf2n &field = curve.get_field();
+	if (!fits(field)) return pE_UNPACKERROR;
+	lnum x(const_cast<unsigned int *>(w), words(field), field);
+	return curve.unpack(x, res);
+}
+
+// Compresses count points of the same curve into compact points res (see epoint::pack_n).
+// Returns error code, indicating result of the operation.
+int cpoint::pack_n(const epoint *points, int count, cpoint *res)
+{
+	int i, j, n, r;
+	if (count <= 0) return pE_OK;
+	const gf2n &field = points[0].get_curve().get_field();
+	if (!fits(field)) return pE_PACKERROR;
+	int len = words(field);
+	lnum *x = new lnum[pBatchLen];
+	for (i = 0; i < count; i += n)
+	{
+		n = min(pBatchLen, count - i);
+		if (r = epoint::pack_n(points + i, n, x))
+		{
+			delete [] x;
+			return r;
+		}
+		for (j = 0; j < n; j++)
+		{
+			memcpy(res[i + j].w, x[j].to_int(), len * sizeof(unsigned int));
+			memset(res[i + j].w + len, 0, (pCompactLen - len) * sizeof(unsigned int));
+		}
+	}
+	delete [] x;
+	return pE_OK;
+}
+
+// Decompresses count compact points into points res of curve curve (see ecurve::unpack_n).
+// Returns error code, indicating result of the operation.
+int cpoint::unpack_n(const ecurve &curve, const cpoint *points, int count, epoint *res)
+{
+	int i, j, n, r;
+	if (count <= 0) return pE_OK;
+	const gf2n &field = curve.get_field();
+	if (!fits(field)) return pE_UNPACKERROR;
+	int len = words(field);
+	lnum *x = new lnum[pBatchLen];
+	for (i = 0; i < count; i += n)
+	{
+		n = min(pBatchLen, count - i);
+		for (j = 0; j < n; j++)
+			x[j] = lnum(const_cast<unsigned int *>(points[i + j].w), len, field);
+		if (r = curve.unpack_n(x, n, res + i))
+		{
+			delete [] x;
+			return r;
+		}
+	}
+	delete [] x;
+	return pE_OK;
+}
+
+// Loads compact point from a record of bytes(field) bytes.
+void cpoint::load(const void *record, const gf2n &field)
+{
+	int n = words(field);
+	memcpy(w, record, n * sizeof(unsigned int));
+	memset(w + n, 0, (pCompactLen - n) * sizeof(unsigned int));
+}
+
+// Stores compact point to a record of bytes(field) bytes.
+void cpoint::store(void *record, const gf2n &field) const
+{
+	memcpy(record, w, words(field) * sizeof(unsigned int));
+}
+
+/* Operators */
+
+// Returns true if compact points are equal.
+bool cpoint::operator== (const cpoint &p) const
+{
+	return memcmp(w, p.w, sizeof(w)) == 0;
+}
+
+// Returns true if compact points differ.
+bool cpoint::operator!= (const cpoint &p) const
+{
+	return memcmp(w, p.w, sizeof(w)) != 0;
+}
+
+// Compares compact points as integers (used to order keys in search trees).
+bool cpoint::operator< (const cpoint &p) const
+{
+	int i;
+	for (i = pCompactLen - 1; i >= 0; i--)
+		if (w[i] != p.w[i]) return w[i] < p.w[i];
+	return false;
+}
+
+// Compares compact points as integers (used to order keys in search trees).
+bool cpoint::operator> (const cpoint &p) const
+{
+	return p < *this;
+}
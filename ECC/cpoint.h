@@ -0,0 +1,38 @@
+#ifndef _CPOINT_H
+#define _CPOINT_H
+
+#include "eccdefines.h"
+
+/* Need some classes */
+class gf2n;
+class epoint;
+class ecurve;
+
+// Compact point: x coordinate of an elliptic point with the solution bit of y stored at bit deg (the same layout epoint::pack produces).
+// Only the first words(field) words are significant, the rest are kept zero, so the structure may be copied, compared and hashed as raw memory.
+// This is the format points are sent between processes, stored in tables and written to ciphertext files.
+struct cpoint
+{
+	/* Helper methods */
+	static int words(const gf2n &field);
+	static int bytes(const gf2n &field);
+	static bool fits(const gf2n &field);
+	unsigned int hash(void) const;
+
+	/* Conversion methods */
+	int from_epoint(const epoint &p);
+	int to_epoint(const ecurve &curve, epoint &res) const;
+	static int pack_n(const epoint *points, int count, cpoint *res);
+	static int unpack_n(const ecurve &curve, const cpoint *points, int count, epoint *res);
+	void load(const void *record, const gf2n &field);
+	void store(void *record, const gf2n &field) const;
+
+	/* Operators */
+	bool operator== (const cpoint &p) const;
+	bool operator!= (const cpoint &p) const;
+	bool operator< (const cpoint &p) const;
+	bool operator> (const cpoint &p) const;
+
+	unsigned int w[pCompactLen];
+};
+#endif
@@ -91,10 +91,11 @@ void crypto::set_G(const epoint &G)
 {
 	if (!curve->belongs_to_curve(G)) cryptoRoutines::op_err(cE_DIFFCURVE);
 	this->G = G;
+	Gcomb.assign(G);
 
 	// recalculate all
-	eccOperations::mul(G, keyA, aG);
-	eccOperations::mul(G, keyB, bG);
+	eccOperations::mul(Gcomb, keyA, aG);
+	eccOperations::mul(Gcomb, keyB, bG);
 	eccOperations::mul(aG, keyB, abG);
 }
 
@@ -104,7 +105,7 @@ void crypto::set_keyA(const bint &keyA)
 	this->keyA = keyA;
 
 	// recalculate all
-	eccOperations::mul(G, keyA, aG);
+	eccOperations::mul(Gcomb, keyA, aG);
 	eccOperations::mul(aG, keyB, abG);
 }
 
@@ -114,7 +115,7 @@ void crypto::set_keyB(const bint &keyB)
 	this->keyB = keyB;
 
 	// recalculate all
-	eccOperations::mul(G, keyB, bG);
+	eccOperations::mul(Gcomb, keyB, bG);
 	eccOperations::mul(bG, keyA, abG);
 }
 
@@ -125,8 +126,8 @@ void crypto::set_keys(const bint &keyA, const bint &keyB)
 	this->keyB = keyB;
 
 	// recalculate all
-	eccOperations::mul(G, keyA, aG);
-	eccOperations::mul(G, keyB, bG);
+	eccOperations::mul(Gcomb, keyA, aG);
+	eccOperations::mul(Gcomb, keyB, bG);
 	eccOperations::mul(aG, keyB, abG);
 }
 
@@ -228,7 +229,7 @@ unsigned char *crypto::decrypt(const epoint *points, int point_count, int &data_
 // This function returns 0 in case of an error.
 unsigned char *crypto::decrypt(const unsigned char *data, int data_length, int &result_length) const
 {
-	int i, j;
+	int i, j, k, n;
 	const gf2n &field = curve->get_field();
 	int fieldDegree = field.get_deg();
 
@@ -241,22 +242,33 @@ unsigned char *crypto::decrypt(const unsigned char *data, int data_length, int &
 
 	int point_count = data_length / bytes_per_point;
 	result_length = point_count * message_length;
-	epoint point(*curve);
+	// Points are unpacked in batches of pBatchLen (one field division per batch).
+	lnum *x = new lnum[pBatchLen];
+	epoint *points = new epoint[pBatchLen];
 	unsigned char *result = new unsigned char[result_length];
-	for (i = 0; i < point_count; i++)
+	for (i = 0; i < point_count; i += n)
 	{
-		lnum x((unsigned int *)(data + i * bytes_per_point), ints_per_point, field);
-		if (curve->unpack(x, point) != cE_OK)
+		n = min(pBatchLen, point_count - i);
+		for (k = 0; k < n; k++)
+			x[k] = lnum((unsigned int *)(data + (i + k) * bytes_per_point), ints_per_point, field);
+		if (curve->unpack_n(x, n, points) != cE_OK)
 		{
 			delete[] result;
+			delete[] points;
+			delete[] x;
 			return 0;
 		}
-		point -= abG;
-		point.unmark(x);
-		unsigned char *value = x.to_char();
-		for (j = 0; j < message_length; j++)
-			result[i * message_length + j] = value[j];
+		for (k = 0; k < n; k++)
+		{
+			points[k] -= abG;
+			points[k].unmark(x[k]);
+			unsigned char *value = x[k].to_char();
+			for (j = 0; j < message_length; j++)
+				result[(i + k) * message_length + j] = value[j];
+		}
 	}
+	delete[] points;
+	delete[] x;
 	return result;
 }
 
@@ -265,7 +277,7 @@ unsigned char *crypto::decrypt(const unsigned char *data, int data_length, int &
 // This function returns 0 in case of an error (unable to unpack point).
 epoint *crypto::convert(const unsigned char *data, int data_length, int &point_count) const
 {
-	int i;
+	int i, k, n;
 	const gf2n &field = curve->get_field();
 	int fieldDegree = field.get_deg();
 
@@ -277,15 +289,21 @@ epoint *crypto::convert(const unsigned char *data, int data_length, int &point_c
 	if (data_length % bytes_per_point != 0) return 0;
 
 	point_count = data_length / bytes_per_point;
+	// Points are unpacked in batches of pBatchLen (one field division per batch).
+	lnum *x = new lnum[pBatchLen];
 	epoint *points = new epoint[point_count];
-	for (i = 0; i < point_count; i++)
+	for (i = 0; i < point_count; i += n)
 	{
-		lnum x((unsigned int *)(data + i * bytes_per_point), ints_per_point, field);
-		if (curve->unpack(x, points[i]) != cE_OK)
+		n = min(pBatchLen, point_count - i);
+		for (k = 0; k < n; k++)
+			x[k] = lnum((unsigned int *)(data + (i + k) * bytes_per_point), ints_per_point, field);
+		if (curve->unpack_n(x, n, points + i) != cE_OK)
 		{
 			delete[] points;
+			delete[] x;
 			return 0;
 		}
 	}
+	delete[] x;
 	return points;
 }
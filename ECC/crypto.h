@@ -4,6 +4,7 @@
 #include "eccdefines.h"
 #include "ecurve.h"
 #include "epoint.h"
+#include "fbpoint.h"
 #include "bint.h"
 
 /* Need some classes */
@@ -57,6 +58,9 @@ private:
 	epoint G, aG, bG, abG;
 	bint keyA, keyB;
 
+	// Comb tables of G, shared by key setups.
+	fbpoint Gcomb;
+
 	int message_length;
 };
 #endif
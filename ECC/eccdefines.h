@@ -8,12 +8,49 @@
 // Number of bits required to definatly mark data on our curve.
 #define pMarkBits 4
 
+// Number of point orders cached by a curve (most recently computed ones are kept).
+#define pOrderCache 4
+
+// Number of points packed or unpacked together (sharing one field division) by pack_n and unpack_n.
+#define pBatchLen   256
+
+/******************************/
+/* cpoint class configuration */
+/******************************/
+
+// Capacity (in 32-bit words) of compact points: fields of degree up to 32 * pCompactLen - 1 fit.
+#define pCompactLen 18
+
+/***************************************/
+/* Scalar multiplication configuration */
+/***************************************/
+
+// Maximum width of non-adjacent form used by scalar multiplication (table holds 2^(w - 2) odd multiples and their negatives).
+#define pNafMaxWidth 6
+
+// Cost of one precomputed odd multiple, measured in mixed additions (full projective addition plus its share of batch normalization).
+#define pNafTableCost 2
+
+// Default memory budget (in bytes) for fixed-base comb tables of a single point.
+#define pCombBudget   131072
+
 /*************************************/
 /* Enum-like constants configuration */
 /*************************************/
 /* Do not edit this                  */
 /*************************************/
 
+/* Scalar multiplication methods */
+
+// Double-and-add family (wNAF, combs, ladder).
+#define pMulDoubling    0
+
+// Halve-and-add: available on curves over odd-degree fields with Tr(a) = 1, used for points of odd order.
+#define pMulHalving     1
+
+// Tau-adic NAF: available on Koblitz curves (a and b lie in GF(2)), Frobenius map replaces doublings.
+#define pMulFrobenius   2
+
 /****************************/
 /* Error code configuration */
 /****************************/
@@ -41,6 +78,12 @@
 // Error: invalid operation on polyom, owned by another field (other than our curves field).
 #define pE_DIFFFIELD   -6
 
+// Error: point halving is not available for this curve or point.
+#define pE_NOHALVING   -7
+
+// Error: Frobenius endomorphism (tau-adic multiplication) is not available for this curve.
+#define pE_NOFROBENIUS -8
+
 /***************************/
 /* Pack code configuration */
 /***************************/
@@ -1,8 +1,11 @@
 #include "eccoperations.h"
 #include "epoint.h"
+#include "ldpoint.h"
+#include "fbpoint.h"
 #include "ecurve.h"
 #include "2n.h"
 #include "2noperations.h"
+#include "2nfactory.h"
 #include "bint.h"
 #include "bintoperations.h"
 
@@ -27,11 +30,68 @@ namespace eccRoutines
 			break;
 		case pE_DIFFFIELD : std::cerr << "(ecc) Exception: invalid operation on polyom, owned by another field (other than our curves field)." << std::endl;
 			break;
+		case pE_NOHALVING : std::cerr << "(ecc) Exception: point halving is not available for this curve or point." << std::endl;
+			break;
+		case pE_NOFROBENIUS : std::cerr << "(ecc) Exception: Frobenius endomorphism is not available for this curve." << std::endl;
+			break;
 		default:
 			std::cerr << "(ecc) Exception: unknown error." << std::endl;
 		}
 		abort();
 	}
+
+	// Adds small integer v (|v| < 2^(bWordBits - 1)) to n-word two's complement number a (bWordBits-bit words, least significant first).
+	void words_add(unsigned int *a, int n, int v)
+	{
+		int i;
+		unsigned int mask = (1u << bWordBits) - 1, ext = (v < 0) ? mask : 0, carry = 0;
+		for (i = 0; i < n; i++)
+		{
+			unsigned int t = a[i] + (i ? ext : (v & mask)) + carry;
+			a[i] = t & mask;
+			carry = t >> bWordBits;
+		}
+	}
+
+	// Adds (or subtracts, if negate is set) n-word two's complement number b to n-word two's complement number a.
+	void words_sum(unsigned int *a, const unsigned int *b, int n, bool negate)
+	{
+		int i;
+		unsigned int mask = (1u << bWordBits) - 1, carry = negate ? 1 : 0;
+		for (i = 0; i < n; i++)
+		{
+			unsigned int t = a[i] + (negate ? ~b[i] & mask : b[i]) + carry;
+			a[i] = t & mask;
+			carry = t >> bWordBits;
+		}
+	}
+
+	// Negates n-word two's complement number a.
+	void words_neg(unsigned int *a, int n)
+	{
+		int i;
+		for (i = 0; i < n; i++)
+			a[i] = ~a[i] & ((1u << bWordBits) - 1);
+		words_add(a, n, 1);
+	}
+
+	// Divides even n-word two's complement number a by two.
+	void words_halve(unsigned int *a, int n)
+	{
+		int i;
+		for (i = 0; i < n - 1; i++)
+			a[i] = (a[i] >> 1) | ((a[i + 1] & 1) << (bWordBits - 1));
+		a[n - 1] = (a[n - 1] >> 1) | (a[n - 1] & (1u << (bWordBits - 1)));
+	}
+
+	// Returns true if n-word number a is zero, otherwise - false.
+	bool words_is_zero(const unsigned int *a, int n)
+	{
+		int i;
+		for (i = 0; i < n; i++)
+			if (a[i]) return false;
+		return true;
+	}
 }
 
 // Inverses elliptic point p and saves result to elliptic point res.
@@ -91,41 +151,1068 @@ int eccOperations::sum(const epoint &p, const epoint &q, epoint &res)
 // Calculates k * p ans saves result to res.
 // Returs error code, indicating result of the operation.
 int eccOperations::mul(const epoint &p, int k, epoint &res)
+{
+	if (can_frobenius(p)) return mul_tnaf(p, bint(k), res);
+	if (can_halve(p)) return mul_halve(p, bint(k), res);
+	unsigned int words[32 / bWordBits + 1];
+	unsigned int t = (k < 0) ? 0u - (unsigned int)k : (unsigned int)k;
+	int count = 0;
+	for (; t != 0; t >>= bWordBits)
+		words[count++] = t & ((1 << bWordBits) - 1);
+	return mul_words(p, words, count, res);
+}
+
+// Calculates k * p ans saves result to res.
+// Returs error code, indicating result of the operation.
+int eccOperations::mul(const epoint &p, bint k, epoint &res)
+{
+	unsigned int words[bWordCount];
+	int count;
+	if (can_frobenius(p)) return mul_tnaf(p, k, res);
+	if (can_halve(p)) return mul_halve(p, k, res);
+	bintOperations::to_words(k, words, count);
+	return mul_words(p, words, count, res);
+}
+
+// Calculates k * p using precomputed comb tables of fixed-base point p and saves result to res.
+// Scalars longer than tables' bit length are multiplied by generic method.
+// Returs error code, indicating result of the operation.
+int eccOperations::mul(const fbpoint &p, bint k, epoint &res)
+{
+	return mul(&p, &k, 1, res);
+}
+
+// Calculates sum of scalars[i] * points[i] (i < count) and saves result to res (scalars are taken by absolute value, as in single-scalar mul).
+// Interleaved wNAF (Straus' method): every point gets its own odd-multiple table, all tables are normalized with one inversion,
+// and a single chain of doublings is shared by all scalars.
+// Returs error code, indicating result of the operation.
+int eccOperations::mul(const epoint *points, const bint *scalars, int count, epoint &res)
+{
+	int i, c, n, w, r = pE_OK, len = 0;
+	if (count <= 0) return pE_UNASSIGNED;
+	for (c = 0; c < count; c++)
+	{
+		if (points[c].curve == 0) return pE_UNASSIGNED;
+		if (points[c].curve != points[0].curve) return pE_DIFFCURVES;
+	}
+	int maxDigits = bWordCount * bWordBits + pNafMaxWidth + 1;
+	unsigned int words[bWordCount];
+	signed char *digits = new signed char[count * maxDigits];
+	int *lens = new int[count];
+	int *offset = new int[count + 1];
+
+	// Recoding scalars and laying out their tables.
+	offset[0] = 0;
+	for (c = 0; c < count; c++)
+	{
+		bintOperations::to_words(scalars[c], words, n);
+		while (n > 0 && !words[n - 1]) n--;
+		lens[c] = 0;
+		w = 2;
+		if (n && !points[c].is_inf())
+		{
+			w = naf_width(n * bWordBits);
+			lens[c] = naf_recode(words, n, w, digits + c * maxDigits);
+		}
+		offset[c + 1] = offset[c] + (lens[c] ? 1 << (w - 2) : 0);
+		if (lens[c] > len) len = lens[c];
+	}
+
+	// Precomputing odd multiples of all points; negatives are stored after all positive entries.
+	int total = offset[count];
+	ldpoint *odd = new ldpoint[total + 1];
+	epoint *table = new epoint[2 * total + 1];
+	for (c = 0; c < count && !r; c++)
+		if (lens[c]) r = naf_precompute(points[c], offset[c + 1] - offset[c], odd + offset[c]);
+	if (!r) r = to_affine(odd, total, table);
+	for (i = 0; i < total && !r; i++)
+		inv(table[i], table[total + i]);
+
+	ldpoint q(*points[0].curve);
+	for (i = len - 1; i >= 0 && !r; i--)
+	{
+		if (!q.is_inf())
+			r = ld_double(q, q);
+		for (c = 0; c < count && !r; c++)
+		{
+			if (i >= lens[c]) continue;
+			int d = digits[c * maxDigits + i];
+			if (d > 0) r = ld_mixed_sum(q, table[offset[c] + (d >> 1)], q);
+			else if (d < 0) r = ld_mixed_sum(q, table[total + offset[c] + ((-d) >> 1)], q);
+		}
+	}
+	if (!r) r = to_affine(q, res);
+
+	delete [] digits;
+	delete [] lens;
+	delete [] offset;
+	delete [] odd;
+	delete [] table;
+	return r;
+}
+
+// Calculates sum of scalars[i] * points[i] (i < count) using comb tables of fixed-base points and saves result to res.
+// When all points have tables of the same layout, one chain of comb doublings is shared by all scalars;
+// otherwise (or for scalars longer than tables' bit length) interleaved wNAF over base points is used.
+// Returs error code, indicating result of the operation.
+int eccOperations::mul(const fbpoint *points, const bint *scalars, int count, epoint &res)
+{
+	int i, j, s, u, c, n, r = pE_OK, size;
+	bool joint = true;
+	if (count <= 0) return pE_UNASSIGNED;
+	for (c = 0; c < count; c++)
+	{
+		if (points[c].base.curve == 0) return pE_UNASSIGNED;
+		if (points[c].base.curve != points[0].base.curve) return pE_DIFFCURVES;
+	}
+	const fbpoint &first = points[0];
+	unsigned int *words = new unsigned int[count * bWordCount];
+	int *bitCount = new int[count];
+	for (c = 0; c < count; c++)
+	{
+		const fbpoint &p = points[c];
+		bintOperations::to_words(scalars[c], words + c * bWordCount, n);
+		bitCount[c] = bit_length(words + c * bWordCount, n);
+		if (!bitCount[c] || p.base.is_inf()) bitCount[c] = 0;
+		else if (!p.table || bitCount[c] > p.bits || p.teeth != first.teeth || p.span != first.span || p.tables != first.tables || p.step != first.step)
+			joint = false;
+	}
+	if (!joint)
+	{
+		// Tables are missing or differ: fall back to interleaved wNAF over base points.
+		epoint *bases = new epoint[count];
+		for (c = 0; c < count; c++)
+			bases[c] = points[c].base;
+		r = mul(bases, scalars, count, res);
+		delete [] bases;
+		delete [] words;
+		delete [] bitCount;
+		return r;
+	}
+
+	// Bit (tooth j, column c) of the comb is scalar bit j * span + c; table s serves columns [s * step, (s + 1) * step).
+	size = (1 << first.teeth) - 1;
+	ldpoint q(*first.base.curve);
+	for (i = first.step - 1; i >= 0 && !r; i--)
+	{
+		if (!q.is_inf())
+			r = ld_double(q, q);
+		for (c = 0; c < count && !r; c++)
+		{
+			const unsigned int *k = words + c * bWordCount;
+			for (s = 0; s < first.tables && !r; s++)
+			{
+				int column = s * first.step + i;
+				if (column >= first.span) continue;
+				u = 0;
+				for (j = 0; j < first.teeth; j++)
+				{
+					int bit = j * first.span + column;
+					if (bit < bitCount[c] && (k[bit / bWordBits] & (1 << (bit % bWordBits)))) u |= 1 << j;
+				}
+				if (u) r = ld_mixed_sum(q, points[c].table[s * size + u - 1], q);
+			}
+		}
+	}
+	if (!r) r = to_affine(q, res);
+	delete [] words;
+	delete [] bitCount;
+	return r;
+}
+
+/* Batch operation routines */
+
+// Adds table[index[i]] to points[i] for every i < count. Negative index[i] doubles points[i] instead.
+// Slopes of all additions share one field division (Montgomery's trick), so each addition costs about three extra multiplications instead of a division.
+// Additions involving infinity, equal or opposite points are rare and fall back to sum.
+// Returns error code, indicating result of the operation.
+int eccOperations::add_n(epoint *points, const epoint *table, const int *index, int count)
 {
 	int i;
-	res.inf();
-	res.curve = p.curve;
-	if (k < 0) k = -k;
-	if (!k) return pE_OK;
-	for (i = 31; i >= 0; i--)
+	if (count <= 0) return pE_OK;
+	const ecurve *ourCurve = points[0].curve;
+	if (ourCurve == 0) return pE_UNASSIGNED;
+	for (i = 0; i < count; i++)
+		if (points[i].curve != ourCurve || (index[i] >= 0 && table[index[i]].curve != ourCurve)) return pE_DIFFCURVES;
+
+	const gf2n &ourField = ourCurve->get_field();
+	lnum *d = new lnum[count];
+	for (i = 0; i < count; i++)
 	{
-		res += res;
-		if (k & (1 << i)) res += p;
+		const epoint &p = points[i];
+		// Zero denominator marks an addition, that takes the general path.
+		if (index[i] < 0)
+		{
+			if (p.is_inf()) d[i] = lnum(ourField);
+			else d[i] = p.x;
+			continue;
+		}
+		const epoint &q = table[index[i]];
+		if (p.is_inf() || q.is_inf() || p.x == q.x) d[i] = lnum(ourField);
+		else d[i] = p.x + q.x;
+	}
+	lnumOperations::inv_n(d, count, d);
+
+	lnum lambda(ourField), x3(ourField);
+	for (i = 0; i < count; i++)
+	{
+		epoint &p = points[i];
+		const epoint &q = index[i] < 0 ? p : table[index[i]];
+		if (d[i].is_zero())
+		{
+			p += q;
+			continue;
+		}
+		if (index[i] < 0)
+		{
+			// Doubling: lambda = x + y / x, y3 = x ^ 2 + (lambda + 1) * x3
+			lambda = p.x + p.y * d[i];
+			x3 = lnumOperations::sqr(lambda) + lambda + ourCurve->a;
+			p.y = lnumOperations::sqr(p.x) + lambda * x3 + x3;
+			p.x = x3;
+			continue;
+		}
+		lambda = (p.y + q.y) * d[i];
+		x3 = lnumOperations::sqr(lambda) + lambda + ourCurve->a + p.x + q.x;
+		p.y = x3 + p.y + lambda * (x3 + p.x);
+		p.x = x3;
 	}
+	delete [] d;
 	return pE_OK;
 }
 
-// Calculates k * p ans saves result to res.
+/* Scalar multiplication routines */
+
+// Chooses width of non-adjacent form for a scalar of a given bit length.
+// Minimizes bits / (w + 1) expected additions plus the cost of precomputing 2^(w - 2) odd multiples.
+int eccOperations::naf_width(int bits)
+{
+	int w, best = 2, bestCost = bits / 3 + pNafTableCost;
+	for (w = 3; w <= pNafMaxWidth; w++)
+	{
+		int cost = bits / (w + 1) + pNafTableCost * (1 << (w - 2));
+		if (cost < bestCost)
+		{
+			best = w;
+			bestCost = cost;
+		}
+	}
+	return best;
+}
+
+// Recodes scalar, given by count bWordBits-bit words (least significant first), into width-w non-adjacent form.
+// Digits are odd values in (-2^(w - 1), 2^(w - 1)) or zeros, least significant first; any w consecutive digits hold at most one non-zero value.
+// Returns number of digits written (at most count * bWordBits + 1).
+int eccOperations::naf_recode(const unsigned int *words, int count, int w, signed char *digits)
+{
+	int i, j, bits = count * bWordBits, len = 0, carry = 0;
+	int mask = (1 << w) - 1, half = 1 << (w - 1);
+	i = 0;
+	while (i < bits || carry)
+	{
+		int bit = (i < bits ? (words[i / bWordBits] >> (i % bWordBits)) & 1 : 0) + carry;
+		if (bit != 1)
+		{
+			// Even remainder: zero digit, carry propagates unchanged (bit == 2 leaves carry set).
+			digits[i++] = 0;
+			continue;
+		}
+		int val = carry;
+		for (j = 0; j < w && i + j < bits; j++)
+			val += ((words[(i + j) / bWordBits] >> ((i + j) % bWordBits)) & 1) << j;
+		val &= mask;
+		if (val >= half)
+		{
+			val -= 1 << w;
+			carry = 1;
+		}
+		else carry = 0;
+		digits[i] = (signed char)val;
+		for (j = 1; j < w; j++)
+			digits[i + j] = 0;
+		i += w;
+	}
+	for (len = i; len > 0 && !digits[len - 1]; len--);
+	return len;
+}
+
+// Returns bit length of a number, given by count bWordBits-bit words (least significant first).
+int eccOperations::bit_length(const unsigned int *words, int count)
+{
+	int bits;
+	while (count > 0 && !words[count - 1]) count--;
+	if (!count) return 0;
+	for (bits = count * bWordBits; !(words[(bits - 1) / bWordBits] & (1 << ((bits - 1) % bWordBits))); bits--);
+	return bits;
+}
+
+// Computes odd multiples p, 3p, ..., (2 * size - 1)p in projective coordinates and saves them to odd.
+// Returns error code, indicating completion result.
+int eccOperations::naf_precompute(const epoint &p, int size, ldpoint *odd)
+{
+	int i, r;
+	odd[0].from_affine(p);
+	if (size > 1)
+	{
+		ldpoint twice;
+		if (r = ld_double(odd[0], twice)) return r;
+		for (i = 1; i < size; i++)
+			if (r = ld_sum(odd[i - 1], twice, odd[i])) return r;
+	}
+	return pE_OK;
+}
+
+// Calculates k * p, where |k| is given by count bWordBits-bit words (least significant first), and saves result to res.
+// Scalar is recoded into width-w NAF, odd multiples p, 3p, ..., (2^(w - 1) - 1)p are precomputed in projective coordinates and
+// normalized with one shared inversion; negative digits add negated table points (negation costs one field addition on binary curves).
+// Main loop works in Lopez-Dahab coordinates with mixed additions, so only the final conversion needs another field inversion.
+int eccOperations::mul_words(const epoint &p, const unsigned int *words, int count, epoint &res)
+{
+	int i, r, len, size;
+	if (p.curve == 0) return pE_UNASSIGNED;
+	while (count > 0 && !words[count - 1]) count--;
+	ldpoint q(*p.curve);
+	if (!count || p.is_inf()) return to_affine(q, res);
+	signed char digits[bWordCount * bWordBits + pNafMaxWidth + 1];
+	int w = naf_width(count * bWordBits);
+	len = naf_recode(words, count, w, digits);
+
+	// Precomputing odd multiples and their negatives.
+	size = 1 << (w - 2);
+	ldpoint odd[1 << (pNafMaxWidth - 2)];
+	epoint table[1 << (pNafMaxWidth - 2)], negTable[1 << (pNafMaxWidth - 2)];
+	if (r = naf_precompute(p, size, odd)) return r;
+	if (r = to_affine(odd, size, table)) return r;
+	for (i = 0; i < size; i++)
+		inv(table[i], negTable[i]);
+
+	for (i = len - 1; i >= 0; i--)
+	{
+		if (!q.is_inf())
+			if (r = ld_double(q, q)) return r;
+		if (digits[i] > 0)
+		{
+			if (r = ld_mixed_sum(q, table[digits[i] >> 1], q)) return r;
+		}
+		else if (digits[i] < 0)
+			if (r = ld_mixed_sum(q, negTable[(-digits[i]) >> 1], q)) return r;
+	}
+	return to_affine(q, res);
+}
+
+/* Fixed-base routines */
+
+// Precomputes comb tables of fixed-base point p according to its layout:
+// entry u of table s is sum of 2^(j * span + s * step) * base over set bits j of u.
+// Tables are built in projective coordinates and normalized with a single inversion.
+// Returns error code, indicating completion result.
+int eccOperations::comb_precompute(fbpoint &p)
+{
+	int i, j, s, u, r = pE_OK;
+	if (p.base.curve == 0) return pE_UNASSIGNED;
+	int size = (1 << p.teeth) - 1;
+	ldpoint *bases = new ldpoint[p.tables * p.teeth];
+	ldpoint *proj = new ldpoint[p.tables * size];
+	ldpoint current(p.base);
+
+	// bases[s * teeth + j] = 2^(j * span + s * step) * base
+	for (i = 0; i < p.teeth * p.span; i++)
+	{
+		int column = i % p.span;
+		if (column % p.step == 0) bases[(column / p.step) * p.teeth + i / p.span] = current;
+		if (r = ld_double(current, current)) break;
+	}
+	for (s = 0; s < p.tables && !r; s++)
+		for (u = 1; u <= size && !r; u++)
+		{
+			for (j = p.teeth - 1; !(u & (1 << j)); j--);
+			if (u == (1 << j)) proj[s * size + u - 1] = bases[s * p.teeth + j];
+			else r = ld_sum(proj[s * size + (u ^ (1 << j)) - 1], bases[s * p.teeth + j], proj[s * size + u - 1]);
+		}
+	if (!r)
+	{
+		p.table = new epoint[p.tables * size];
+		r = to_affine(proj, p.tables * size, p.table);
+	}
+	delete [] bases;
+	delete [] proj;
+	return r;
+}
+
+/* Point halving routines */
+
+// Returns true if halve-and-add is selected for curve of point p and p lies in odd-order subgroup (Tr(x) = Tr(a) = 1), otherwise - false.
+bool eccOperations::can_halve(const epoint &p)
+{
+	return p.curve != 0 && p.curve->mulMethod == pMulHalving && !p.is_inf() && p.x.trace();
+}
+
+// Halves point Q = (u, v) with lambda-representation (u, lambdaU), lambdaU = u + v / u, and saves half P in lambda-representation (x, lambda).
+// Q must lie in odd-order subgroup of a curve with Tr(a) = 1, then P is the unique half of Q in that subgroup (Knudsen, Schroeppel):
+// lambda' solves lambda'^2 + lambda' = u + a, t = u * (u + lambdaU + lambda'); if Tr(t) = 0, then P = (sqrt(t + u), lambda'), else P = (sqrt(t), lambda' + 1).
+// Costs a half-trace, a square root, a multiplication and a trace.
+void eccOperations::halve_lambda(const ecurve &curve, const lnum &u, const lnum &lambdaU, lnum &x, lnum &lambda)
+{
+	lnum l = (u + curve.a).half_trace();
+	lnum t = u * (u + lambdaU + l);
+	if (t.trace())
+	{
+		l.set_bit(0);
+		x = lnumOperations::sqrt(t);
+	}
+	else x = lnumOperations::sqrt(t + u);
+	lambda = l;
+}
+
+// Halves point p: finds the unique point res of odd order with 2 * res = p.
+// Curve must have halving method selected and p must lie in its odd-order subgroup.
 // Returs error code, indicating result of the operation.
-int eccOperations::mul(const epoint &p, bint k, epoint &res)
+int eccOperations::halve(const epoint &p, epoint &res)
 {
-	//int i,j;
-	res.inf();
+	if (p.curve == 0) return pE_UNASSIGNED;
+	if (p.is_inf())
+	{
+		res = p;
+		return pE_OK;
+	}
+	if (!can_halve(p)) return pE_NOHALVING;
+	lnum x(p.x), lambda = p.x + p.y / p.x;
+	halve_lambda(*p.curve, p.x, lambda, x, lambda);
 	res.curve = p.curve;
+	res.y = x * (x + lambda);
+	res.x = x;
+	return pE_OK;
+}
+
+// Calculates k * p with right-to-left halve-and-add and saves result to res (as in mul, |k| is used).
+// With n the odd order of subgroup, t its bit length and k' = 2^(t - 1) * k mod n recoded into width-w NAF (digits k'_i),
+// k * p = sum of k'_i * (p / 2^(t - 1 - i)). Halvings of p run in affine lambda-representation, every non-zero digit adds
+// the current half to projective accumulator Q_|k'_i| (mixed addition), and the result is sum of j * Q_j over odd j.
+// Curve must have halving method selected and p must lie in its odd-order subgroup.
+// Returs error code, indicating result of the operation.
+int eccOperations::mul_halve(const epoint &p, bint k, epoint &res)
+{
+	unsigned int words[bWordCount];
+	int i, r, count, len, t, w, size;
+	if (p.curve == 0) return pE_UNASSIGNED;
+	const ecurve &curve = *p.curve;
+	if (p.is_inf() || k.is_zero())
+	{
+		res.curve = p.curve;
+		res.inf();
+		return pE_OK;
+	}
+	if (!can_halve(p)) return pE_NOHALVING;
+	const bint &n = curve.oddOrder;
+
+	// Recoding k' = 2^(t - 1) * k mod n.
 	if (k.is_less_zero()) k = -k;
-	if (k.is_zero()) return pE_OK;
-	bint one; one.one();
-	epoint p2 = p;
-	while (!k.is_zero())
-		if (!k.is_odd())
+	bintOperations::to_words(n, words, count);
+	t = bit_length(words, count);
+	bint power;
+	if (r = bintOperations::pow(bint(2), t - 1, power)) bintRoutines::op_err(r);
+	k = ((k % n) * power) % n;
+	bintOperations::to_words(k, words, count);
+	while (count > 0 && !words[count - 1]) count--;
+	ldpoint q(curve);
+	if (!count) return to_affine(q, res);
+	signed char digits[bWordCount * bWordBits + pNafMaxWidth + 1];
+	w = naf_width(t);
+	len = naf_recode(words, count, w, digits);
+
+	size = 1 << (w - 2);
+	ldpoint acc[1 << (pNafMaxWidth - 2)];
+	for (i = 0; i < size; i++)
+		acc[i] = q;
+
+	// Digit at position t - 1 adds p itself, every lower position adds the next half.
+	lnum x(p.x), lambda = p.x + p.y / p.x;
+	epoint half(curve);
+	for (i = t - 1; i >= 0; i--)
+	{
+		if (i < len && digits[i])
 		{
-			p2 += p2;
-			k = k / 2;
+			half.x = x;
+			half.y = x * (x + lambda);
+			if (digits[i] < 0) half.y += x;
+			if (r = ld_mixed_sum(acc[abs(digits[i]) >> 1], half, acc[abs(digits[i]) >> 1])) return r;
 		}
-		else
+		if (i > 0) halve_lambda(curve, x, lambda, x, lambda);
+	}
+
+	// Digit at position t multiplies 2 * p.
+	if (len > t && digits[t])
+	{
+		epoint twice = p + p;
+		if (digits[t] < 0) inv(twice, twice);
+		if (r = ld_mixed_sum(acc[abs(digits[t]) >> 1], twice, acc[abs(digits[t]) >> 1])) return r;
+	}
+
+	// sum of (2i + 1) * acc[i] = sum of acc[i] + 2 * sum of i * acc[i]; the latter is the sum of suffix sums.
+	ldpoint suffix(curve), weighted(curve);
+	for (i = size - 1; i >= 1; i--)
+	{
+		if (r = ld_sum(suffix, acc[i], suffix)) return r;
+		if (r = ld_sum(weighted, suffix, weighted)) return r;
+	}
+	if (r = ld_sum(suffix, acc[0], q)) return r;
+	if (r = ld_double(weighted, weighted)) return r;
+	if (r = ld_sum(q, weighted, q)) return r;
+	return to_affine(q, res);
+}
+
+/* Frobenius endomorphism routines */
+
+// Returns true if tau-adic method is selected for curve of point p, otherwise - false.
+bool eccOperations::can_frobenius(const epoint &p)
+{
+	return p.curve != 0 && p.curve->mulMethod == pMulFrobenius;
+}
+
+// Computes tau^m = a + b * tau in Z[tau], where tau^2 = mu * tau - 2.
+void eccOperations::tau_power(int mu, int m, bint &a, bint &b)
+{
+	int i;
+	bint t;
+	a = bint(1);
+	b = bint(0);
+	// tau^(i + 1) = tau * (a + b * tau) = -2 * b + (a + mu * b) * tau.
+	for (i = 0; i < m; i++)
+	{
+		t = a + bint(mu) * b;
+		a = -(b + b);
+		b = t;
+	}
+}
+
+// Computes tau-adic NAF parameters of Koblitz curve: mu, tau^m - 1 and its norm and, for every NAF width w, image of tau modulo tau^w
+// and representatives alpha_u = u mods tau^w of odd u < 2^(w - 1).
+void eccOperations::tnaf_setup(ecurve &curve)
+{
+	int u, w, mu = curve.a.is_zero() ? -1 : 1;
+	curve.tauMu = mu;
+
+	bint A, B;
+	tau_power(mu, curve.field->get_deg(), A, B);
+	curve.tauModule[0] = A - bint(1);
+	curve.tauModule[1] = B;
+	curve.tauNorm = curve.tauModule[0] * curve.tauModule[0] + bint(mu) * curve.tauModule[0] * curve.tauModule[1] +
+		bint(2) * curve.tauModule[1] * curve.tauModule[1];
+
+	// Recurrence of tau_power for tau^w = a + b * tau with small numbers; b is odd, so tau maps to t = -a / b modulo 2^w.
+	int a = 0, b = 1, c;
+	bint r0, r1;
+	for (w = 2; w <= pNafMaxWidth; w++)
+	{
+		c = a + mu * b;
+		a = -2 * b;
+		b = c;
+		for (curve.tauT[w] = 0; (a + b * curve.tauT[w]) & ((1 << w) - 1); curve.tauT[w]++);
+		for (u = 1; u < (1 << (w - 1)); u += 2)
 		{
-			res += p2;
-			k -= one;
+			tnaf_round_div(mu, bint(u), bint(0), bint(a), bint(b), bint(1 << w), r0, r1);
+			curve.tauAlpha[w][u >> 1][0] = r0.is_less_zero() ? -(int)r0.low_int() : (int)r0.low_int();
+			curve.tauAlpha[w][u >> 1][1] = r1.is_less_zero() ? -(int)r1.low_int() : (int)r1.low_int();
 		}
+	}
+}
+
+// Divides k = k0 + k1 * tau by s = s0 + s1 * tau (norm is the norm of s) in Z[tau], rounds the quotient q with Solinas' rounding
+// and saves remainder k - q * s to r0 + r1 * tau. Rounding keeps the norm of the remainder at most 4 / 7 of the norm of s.
+void eccOperations::tnaf_round_div(int mu, const bint &k0, const bint &k1, const bint &s0, const bint &s1, const bint &norm, bint &r0, bint &r1)
+{
+	int i, h0 = 0, h1 = 0;
+	bint g[2], f[2], e[2], t;
+	bint twoNorm = norm + norm;
+
+	// k / s = k * conj(s) / norm, conj(s) = (s0 + mu * s1) - s1 * tau.
+	g[0] = k0 * (s0 + bint(mu) * s1) + bint(2) * k1 * s1;
+	g[1] = k1 * s0 - k0 * s1;
+
+	// f_i = round(g_i / norm), e_i = g_i - f_i * norm, so fractional parts of the quotient are e_i / norm in [-1/2, 1/2).
+	for (i = 0; i < 2; i++)
+	{
+		t = g[i] + g[i] + norm;
+		f[i] = t / twoNorm;
+		if ((t % twoNorm).is_less_zero()) f[i] -= bint(1);
+		e[i] = g[i] - f[i] * norm;
+	}
+
+	// Solinas' rounding of the fractional parts, all conditions multiplied by norm.
+	bint eta = e[0] + e[0] + bint(mu) * e[1];
+	bint first = e[0] - bint(3 * mu) * e[1];
+	bint second = e[0] + bint(4 * mu) * e[1];
+	if (eta >= norm)
+	{
+		if (first < -norm) h1 = mu; else h0 = 1;
+	}
+	else if (second >= twoNorm) h1 = mu;
+	if (eta < -norm)
+	{
+		if (first >= norm) h1 = -mu; else h0 = -1;
+	}
+	else if (second < -twoNorm) h1 = -mu;
+	f[0] += bint(h0);
+	f[1] += bint(h1);
+
+	// q * s = (q0 * s0 - 2 * q1 * s1) + (q0 * s1 + q1 * s0 + mu * q1 * s1) * tau.
+	r0 = k0 - f[0] * s0 + bint(2) * f[1] * s1;
+	r1 = k1 - f[0] * s1 - f[1] * s0 - bint(mu) * f[1] * s1;
+}
+
+// Recodes k0 + k1 * tau into width-w tau-adic NAF (t is the image of tau modulo tau^w, alpha[u / 2] holds alpha_u for odd u).
+// Digits are odd values u in (-2^(w - 1), 2^(w - 1)) or zeros, least significant first, digit u stands for alpha_u and -u for -alpha_u;
+// any w consecutive digits hold at most one non-zero value. Coefficients are kept in two's complement word arrays.
+// Returns number of digits written (about log2 of the norm of k plus w).
+int eccOperations::tnaf_recode(int mu, int w, int t, const int (*alpha)[2], const bint &k0, const bint &k1, signed char *digits)
+{
+	unsigned int r[2][bWordCount + 2];
+	unsigned int *a = r[0], *b = r[1], *c;
+	int i, n, count[2], len = 0;
+	int mask = (1 << w) - 1, half = 1 << (w - 1);
+	bintOperations::to_words(k0, r[0], count[0]);
+	bintOperations::to_words(k1, r[1], count[1]);
+	n = max(count[0], count[1]) + 2;
+	for (i = count[0]; i < n; i++) r[0][i] = 0;
+	for (i = count[1]; i < n; i++) r[1][i] = 0;
+	if (k0.is_less_zero()) eccRoutines::words_neg(r[0], n);
+	if (k1.is_less_zero()) eccRoutines::words_neg(r[1], n);
+
+	while (!eccRoutines::words_is_zero(a, n) || !eccRoutines::words_is_zero(b, n))
+	{
+		int u = 0;
+		if (a[0] & 1)
+		{
+			// u = (a + b * t) mods 2^w, subtracting alpha_u makes a + b * tau divisible by tau^w.
+			u = (int)((a[0] + b[0] * t) & mask);
+			if (u >= half) u -= 1 << w;
+			const int *alphaU = alpha[abs(u) >> 1];
+			eccRoutines::words_add(a, n, u > 0 ? -alphaU[0] : alphaU[0]);
+			eccRoutines::words_add(b, n, u > 0 ? -alphaU[1] : alphaU[1]);
+		}
+		digits[len++] = (signed char)u;
+		// (a + b * tau) / tau = (b + mu * a / 2) - (a / 2) * tau.
+		eccRoutines::words_halve(a, n);
+		eccRoutines::words_sum(b, a, n, mu < 0);
+		eccRoutines::words_neg(a, n);
+		c = a; a = b; b = c;
+	}
+	return len;
+}
+
+// Computes alpha_u * p for odd u < 2^(w - 1) (alpha_u are width-w representatives of curve of p) and saves them to table in affine coordinates.
+// Every alpha_u has a short plain tau-adic NAF, so it costs a few Frobenius maps and mixed additions; table is normalized with one inversion.
+// Returns error code, indicating completion result.
+int eccOperations::tnaf_precompute(const epoint &p, int w, epoint *table)
+{
+	static const int unit[1][2] = {{1, 0}};
+	int i, j, r, len, size = 1 << (w - 2);
+	const ecurve &curve = *p.curve;
+	if (size == 1)
+	{
+		table[0] = p;
+		return pE_OK;
+	}
+	signed char digits[4 * pNafMaxWidth + 8];
+	ldpoint proj[1 << (pNafMaxWidth - 2)];
+	epoint negP;
+	inv(p, negP);
+	for (j = 0; j < size; j++)
+	{
+		proj[j] = ldpoint(curve);
+		len = tnaf_recode(curve.tauMu, 2, 2, unit, bint(curve.tauAlpha[w][j][0]), bint(curve.tauAlpha[w][j][1]), digits);
+		for (i = len - 1; i >= 0; i--)
+		{
+			if (r = ld_frobenius(proj[j], proj[j])) return r;
+			if (digits[i])
+				if (r = ld_mixed_sum(proj[j], digits[i] > 0 ? p : negP, proj[j])) return r;
+		}
+	}
+	return to_affine(proj, size, table);
+}
+
+// Applies Frobenius map to point p: res = (x^2, y^2). Curve of p must be a Koblitz curve.
+// Returs error code, indicating result of the operation.
+int eccOperations::frobenius(const epoint &p, epoint &res)
+{
+	if (p.curve == 0) return pE_UNASSIGNED;
+	if (!p.curve->is_koblitz()) return pE_NOFROBENIUS;
+	res.curve = p.curve;
+	if (p.is_inf())
+	{
+		res.inf();
+		return pE_OK;
+	}
+	res.x = lnumOperations::sqr(p.x);
+	res.y = lnumOperations::sqr(p.y);
+	return pE_OK;
+}
+
+// Replaces point p by the representative of its class {+-tau^i(p)}: the conjugate tau^i(p) with the least x
+// (found by m - 1 squarings), negated if needed to be canonical (see epoint::canonize). Curve of p must be a Koblitz curve.
+// Saves i to power and whether the point was negated to negated, so the representative is (negated ? -1 : 1) * tau^power(p).
+// Returs error code, indicating result of the operation.
+int eccOperations::frobenius_canonize(epoint &p, int &power, bool &negated)
+{
+	power = 0;
+	negated = false;
+	if (p.curve == 0) return pE_UNASSIGNED;
+	if (!p.curve->is_koblitz()) return pE_NOFROBENIUS;
+	if (p.is_inf()) return pE_OK;
+
+	lnum t(p.x);
+	lnumOperations::least_conjugate(t, p.x, power);
+	if (power != 0)
+	{
+		t = p.y;
+		lnumOperations::frobenius(t, power, p.y);
+	}
+	negated = p.canonize();
+	return pE_OK;
+}
+
+// Calculates k * p with width-w tau-adic NAF and saves result to res (as in mul, |k| is used).
+// Scalars longer than m / 2 bits are partially reduced modulo tau^m - 1, which maps every point of the curve to infinity, so
+// rho = k mod (tau^m - 1) has about m tau-adic digits and rho * p = k * p; shorter scalars are recoded as they are (about 2 * log2(k) digits).
+// Width is chosen by the number of digits. Main loop applies Frobenius map (three squarings in projective coordinates) instead of doubling
+// and adds precomputed alpha_u * p for non-zero digits. Curve of p must have Frobenius method selected.
+// Returs error code, indicating result of the operation.
+int eccOperations::mul_tnaf(const epoint &p, bint k, epoint &res)
+{
+	unsigned int words[bWordCount];
+	int i, r, len, size, count, bits, w;
+	if (p.curve == 0) return pE_UNASSIGNED;
+	const ecurve &curve = *p.curve;
+	if (!can_frobenius(p)) return pE_NOFROBENIUS;
+	ldpoint q(curve);
+	if (p.is_inf() || k.is_zero()) return to_affine(q, res);
+	if (k.is_less_zero()) k = -k;
+
+	int m = curve.field->get_deg();
+	bint r0(k), r1;
+	bintOperations::to_words(k, words, count);
+	bits = bit_length(words, count);
+	if (2 * bits > m)
+	{
+		tnaf_round_div(curve.tauMu, k, bint(0), curve.tauModule[0], curve.tauModule[1], curve.tauNorm, r0, r1);
+		bits = m;
+	}
+	else bits *= 2;
+	w = naf_width(bits);
+	signed char digits[lLen * lbLen + 2 * pNafMaxWidth + 8];
+	len = tnaf_recode(curve.tauMu, w, curve.tauT[w], curve.tauAlpha[w], r0, r1, digits);
+
+	size = 1 << (w - 2);
+	epoint table[1 << (pNafMaxWidth - 2)], negTable[1 << (pNafMaxWidth - 2)];
+	if (r = tnaf_precompute(p, w, table)) return r;
+	for (i = 0; i < size; i++)
+		inv(table[i], negTable[i]);
+
+	for (i = len - 1; i >= 0; i--)
+	{
+		if (r = ld_frobenius(q, q)) return r;
+		if (digits[i] > 0)
+		{
+			if (r = ld_mixed_sum(q, table[digits[i] >> 1], q)) return r;
+		}
+		else if (digits[i] < 0)
+			if (r = ld_mixed_sum(q, negTable[(-digits[i]) >> 1], q)) return r;
+	}
+	return to_affine(q, res);
+}
+
+/* Montgomery ladder routines */
+
+// Runs Lopez-Dahab x-only Montgomery ladder for a point with non-zero x-coordinate x on curve curve and scalar |k|,
+// given by count bWordBits-bit words (least significant first).
+// Saves x-coordinates of k * p and (k + 1) * p as (X1 : Z1) and (X2 : Z2), where x = X / Z and Z = 0 stands for infinity.
+// Every bit costs one differential addition and one doubling (6 multiplications, 5 squarings) and the same instruction flow.
+void eccOperations::ladder_words(const ecurve &curve, const lnum &x, const unsigned int *words, int count, lnum &X1, lnum &Z1, lnum &X2, lnum &Z2)
+{
+	int i;
+	X1.one();
+	Z1.zero();
+	X2 = x;
+	Z2.one();
+	for (i = bit_length(words, count) - 1; i >= 0; i--)
+	{
+		bool bit = ((words[i / bWordBits] >> (i % bWordBits)) & 1) != 0;
+		lnumOperations::cswap(X1, X2, bit);
+		lnumOperations::cswap(Z1, Z2, bit);
+
+		// (X2 : Z2) = R0 + R1, where R1 - R0 = p.
+		lnum A = X1 * Z2, B = X2 * Z1;
+		Z2 = lnumOperations::sqr(A + B);
+		X2 = x * Z2 + A * B;
+
+		// (X1 : Z1) = 2 * R0.
+		lnum X1s = lnumOperations::sqr(X1), Z1s = lnumOperations::sqr(Z1);
+		Z1 = X1s * Z1s;
+		X1 = lnumOperations::sqr(X1s) + curve.b * lnumOperations::sqr(Z1s);
+
+		lnumOperations::cswap(X1, X2, bit);
+		lnumOperations::cswap(Z1, Z2, bit);
+	}
+}
+
+// Calculates k * p with Montgomery ladder and saves result to res. The y-coordinate is recovered from x-coordinates
+// of k * p and (k + 1) * p with one inversion: with D = x * Z1 * Z2, x1 = X1 * x * Z2 / D and
+// y1 = (x1 + x) * ((X1 + x * Z1) * (X2 + x * Z2) + (x^2 + y) * Z1 * Z2) / D + y.
+// Returs error code, indicating result of the operation.
+int eccOperations::ladder(const epoint &p, bint k, epoint &res)
+{
+	unsigned int words[bWordCount];
+	int count;
+	if (p.curve == 0) return pE_UNASSIGNED;
+	bintOperations::to_words(k, words, count);
+	while (count > 0 && !words[count - 1]) count--;
+	const gf2n &ourField = p.curve->get_field();
+	if (!count || p.is_inf())
+	{
+		res.curve = p.curve;
+		res.inf();
+		return pE_OK;
+	}
+	if (p.x.is_zero())
+	{
+		// p = (0, sqrt(b)) has order 2.
+		res = p;
+		if (!(words[0] & 1)) res.inf();
+		return pE_OK;
+	}
+	lnum X1(ourField), Z1(ourField), X2(ourField), Z2(ourField);
+	ladder_words(*p.curve, p.x, words, count, X1, Z1, X2, Z2);
+	if (Z1.is_zero())
+	{
+		res.curve = p.curve;
+		res.inf();
+		return pE_OK;
+	}
+	if (Z2.is_zero())
+		return inv(p, res);
+	lnum xZ2 = p.x * Z2;
+	lnum T(ourField);
+	T.one();
+	T = T / (xZ2 * Z1);
+	lnum x1 = X1 * xZ2 * T;
+	lnum N = (X1 + p.x * Z1) * (X2 + xZ2) + (lnumOperations::sqr(p.x) + p.y) * Z1 * Z2;
+	res.curve = p.curve;
+	res.y = (x1 + p.x) * N * T + p.y;
+	res.x = x1;
+	return pE_OK;
+}
+
+// Calculates x-coordinate of k * p with Montgomery ladder and saves it to x; inf is set, if k * p is infinity point (x is not changed then).
+// Returs error code, indicating result of the operation.
+int eccOperations::mul_x(const epoint &p, bint k, lnum &x, bool &inf)
+{
+	if (p.curve == 0) return pE_UNASSIGNED;
+	if (p.is_inf())
+	{
+		inf = true;
+		return pE_OK;
+	}
+	return mul_x(*p.curve, p.x, k, x, inf);
+}
+
+// Calculates x-coordinate of k * p, where p is a point on curve curve with x-coordinate x, and saves it to res.
+// Flag inf is set, if k * p is infinity point (res is not changed then). Infinity point itself can not be passed here.
+// Returs error code, indicating result of the operation.
+int eccOperations::mul_x(const ecurve &curve, const lnum &x, bint k, lnum &res, bool &inf)
+{
+	unsigned int words[bWordCount];
+	int count;
+	if (!curve.is_over_field(x.get_field())) return pE_DIFFFIELD;
+	bintOperations::to_words(k, words, count);
+	while (count > 0 && !words[count - 1]) count--;
+	inf = !count;
+	if (inf) return pE_OK;
+	if (x.is_zero())
+	{
+		// (0, sqrt(b)) has order 2.
+		inf = !(words[0] & 1);
+		if (!inf) res = x;
+		return pE_OK;
+	}
+	const gf2n &ourField = curve.get_field();
+	lnum X1(ourField), Z1(ourField), X2(ourField), Z2(ourField);
+	ladder_words(curve, x, words, count, X1, Z1, X2, Z2);
+	inf = Z1.is_zero();
+	if (!inf) res = X1 / Z1;
+	return pE_OK;
+}
+
+/* Projective operation routines */
+
+// Converts projective point p to affine point res: (X : Y : Z) -> (X / Z, Y / Z^2).
+// Returns error code, indicating completion result.
+int eccOperations::to_affine(const ldpoint &p, epoint &res)
+{
+	if (p.curve == 0) return pE_UNASSIGNED;
+	res.curve = p.curve;
+	if (p.is_inf())
+	{
+		res.inf();
+		return pE_OK;
+	}
+	lnum zInv(p.curve->get_field());
+	zInv.one();
+	zInv = zInv / p.Z;
+	res.x = p.X * zInv;
+	res.y = p.Y * lnumOperations::sqr(zInv);
+	return pE_OK;
+}
+
+// Converts count projective points p to affine points res using a single field inversion (Montgomery's simultaneous inversion).
+// Returns error code, indicating completion result.
+int eccOperations::to_affine(const ldpoint *p, int count, epoint *res)
+{
+	int i;
+	if (count <= 0) return pE_OK;
+	for (i = 0; i < count; i++)
+		if (p[i].curve == 0) return pE_UNASSIGNED;
+	if (count == 1) return to_affine(p[0], res[0]);
+	const gf2n &ourField = p[0].curve->get_field();
+	lnum *prefix = new lnum[count];
+	lnum acc(ourField), zInv(ourField);
+	acc.one();
+	// prefix[i] is product of all non-zero Z among p[0..i - 1]; infinity points are skipped.
+	for (i = 0; i < count; i++)
+	{
+		prefix[i] = acc;
+		if (!p[i].is_inf()) acc = acc * p[i].Z;
+	}
+	zInv.one();
+	zInv = zInv / acc;
+	// zInv is inverse of product of non-zero Z among p[0..i], so 1 / Z_i = zInv * prefix[i].
+	for (i = count - 1; i >= 0; i--)
+	{
+		res[i].curve = p[i].curve;
+		if (p[i].is_inf())
+		{
+			res[i].inf();
+			continue;
+		}
+		lnum z = zInv * prefix[i];
+		zInv = zInv * p[i].Z;
+		res[i].x = p[i].X * z;
+		res[i].y = p[i].Y * lnumOperations::sqr(z);
+	}
+	delete [] prefix;
+	return pE_OK;
+}
+
+// Doubles projective point p and saves result to res.
+// Z3 = X1^2 * Z1^2, X3 = X1^4 + b * Z1^4, Y3 = b * Z1^4 * Z3 + X3 * (a * Z3 + Y1^2 + b * Z1^4).
+// Returns error code, indicating completion result.
+int eccOperations::ld_double(const ldpoint &p, ldpoint &res)
+{
+	if (p.curve == 0) return pE_UNASSIGNED;
+	if (p.is_inf())
+	{
+		res = p;
+		return pE_OK;
+	}
+	lnum X2 = lnumOperations::sqr(p.X);
+	lnum Z2 = lnumOperations::sqr(p.Z);
+	lnum Z3 = X2 * Z2;
+	lnum bZ4 = p.curve->b * lnumOperations::sqr(Z2);
+	lnum X3 = lnumOperations::sqr(X2) + bZ4;
+	res.Y = bZ4 * Z3 + X3 * (p.curve->a * Z3 + lnumOperations::sqr(p.Y) + bZ4);
+	res.X = X3;
+	res.Z = Z3;
+	res.curve = p.curve;
+	return pE_OK;
+}
+
+// Calculates sum of two projective points and saves result to res.
+// With U1 = X1 * Z2, U2 = X2 * Z1, S1 = Y1 * Z2^2, S2 = Y2 * Z1^2, A = S1 + S2, B = U1 + U2, C = Z1 * Z2, D = B * C, W = B * D, E = A * D:
+// Z3 = D^2, X3 = A^2 + E + W * (B + a * C), Y3 = E * (U1 * W + X3) + X3 * Z3 + S1 * W^2.
+// Returns error code, indicating completion result.
+int eccOperations::ld_sum(const ldpoint &p, const ldpoint &q, ldpoint &res)
+{
+	if (p.curve == 0 || q.curve == 0) return pE_UNASSIGNED;
+	if (p.curve != q.curve) return pE_DIFFCURVES;
+	if (p.is_inf())
+	{
+		res = q;
+		return pE_OK;
+	}
+	if (q.is_inf())
+	{
+		res = p;
+		return pE_OK;
+	}
+	lnum U1 = p.X * q.Z;
+	lnum S1 = p.Y * lnumOperations::sqr(q.Z);
+	lnum A = S1 + q.Y * lnumOperations::sqr(p.Z);
+	lnum B = U1 + q.X * p.Z;
+	if (B.is_zero())
+	{
+		if (A.is_zero()) return ld_double(p, res);
+		res.curve = p.curve;
+		res.inf();
+		return pE_OK;
+	}
+	lnum C = p.Z * q.Z;
+	lnum D = B * C;
+	lnum W = B * D;
+	lnum E = A * D;
+	lnum Z3 = lnumOperations::sqr(D);
+	lnum X3 = lnumOperations::sqr(A) + E + W * (B + p.curve->a * C);
+	res.Y = E * (U1 * W + X3) + X3 * Z3 + S1 * lnumOperations::sqr(W);
+	res.X = X3;
+	res.Z = Z3;
+	res.curve = p.curve;
+	return pE_OK;
+}
+
+// Calculates sum of projective point p and affine point q and saves result to res.
+// Same formulas as in ld_sum with Z2 = 1, which saves three multiplications and a squaring.
+// Returns error code, indicating completion result.
+int eccOperations::ld_mixed_sum(const ldpoint &p, const epoint &q, ldpoint &res)
+{
+	if (p.curve == 0 || q.curve == 0) return pE_UNASSIGNED;
+	if (p.curve != q.curve) return pE_DIFFCURVES;
+	if (q.is_inf())
+	{
+		res = p;
+		return pE_OK;
+	}
+	if (p.is_inf())
+	{
+		res.from_affine(q);
+		return pE_OK;
+	}
+	lnum A = p.Y + q.y * lnumOperations::sqr(p.Z);
+	lnum B = p.X + q.x * p.Z;
+	if (B.is_zero())
+	{
+		if (A.is_zero()) return ld_double(ldpoint(q), res);
+		res.curve = p.curve;
+		res.inf();
+		return pE_OK;
+	}
+	lnum D = B * p.Z;
+	lnum W = B * D;
+	lnum E = A * D;
+	lnum Z3 = lnumOperations::sqr(D);
+	lnum X3 = lnumOperations::sqr(A) + E + W * (B + p.curve->a * p.Z);
+	res.Y = E * (p.X * W + X3) + X3 * Z3 + p.Y * lnumOperations::sqr(W);
+	res.X = X3;
+	res.Z = Z3;
+	res.curve = p.curve;
+	return pE_OK;
+}
+
+// Applies Frobenius map to projective point p: (X : Y : Z) -> (X^2 : Y^2 : Z^2). Curve of p must be a Koblitz curve.
+// Returns error code, indicating completion result.
+int eccOperations::ld_frobenius(const ldpoint &p, ldpoint &res)
+{
+	if (p.curve == 0) return pE_UNASSIGNED;
+	res.X = lnumOperations::sqr(p.X);
+	res.Y = lnumOperations::sqr(p.Y);
+	res.Z = lnumOperations::sqr(p.Z);
+	res.curve = p.curve;
 	return pE_OK;
 }
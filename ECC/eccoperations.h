@@ -3,6 +3,10 @@
 
 /* Need some classes */
 class epoint;
+class ldpoint;
+class fbpoint;
+class ecurve;
+class lnum;
 class bint;
 
 // Predefining global external functions
@@ -25,8 +29,66 @@ private:
 public:
 	static int mul(const epoint &p, int k, epoint &res);
 	static int mul(const epoint &p, bint k, epoint &res);
+	static int mul(const fbpoint &p, bint k, epoint &res);
+	static int mul(const epoint *points, const bint *scalars, int count, epoint &res);
+	static int mul(const fbpoint *points, const bint *scalars, int count, epoint &res);
+
+	/* Batch operation routines */
+	static int add_n(epoint *points, const epoint *table, const int *index, int count);
+
+	/* Point halving routines */
+	static int halve(const epoint &p, epoint &res);
+	static int mul_halve(const epoint &p, bint k, epoint &res);
+
+	/* Frobenius endomorphism routines */
+	// Koblitz curves only: tau(x, y) = (x^2, y^2).
+	static int frobenius(const epoint &p, epoint &res);
+	static int frobenius_canonize(epoint &p, int &power, bool &negated);
+	static void tau_power(int mu, int m, bint &a, bint &b);
+	static int mul_tnaf(const epoint &p, bint k, epoint &res);
+
+	/* Montgomery ladder routines */
+	// x-only: use these, when y-coordinate of the result is not needed (e.g. order tests).
+	static int ladder(const epoint &p, bint k, epoint &res);
+	static int mul_x(const epoint &p, bint k, lnum &x, bool &inf);
+	static int mul_x(const ecurve &curve, const lnum &x, bint k, lnum &res, bool &inf);
+
+	/* Projective operation routines */
+	static int to_affine(const ldpoint &p, epoint &res);
+	static int to_affine(const ldpoint *p, int count, epoint *res);
+	static int ld_double(const ldpoint &p, ldpoint &res);
+	static int ld_sum(const ldpoint &p, const ldpoint &q, ldpoint &res);
+	static int ld_mixed_sum(const ldpoint &p, const epoint &q, ldpoint &res);
+	static int ld_frobenius(const ldpoint &p, ldpoint &res);
+
+private:
+	/* Scalar multiplication routines */
+	static int bit_length(const unsigned int *words, int count);
+	static int naf_width(int bits);
+	static int naf_recode(const unsigned int *words, int count, int w, signed char *digits);
+	static int naf_precompute(const epoint &p, int size, ldpoint *odd);
+	static int mul_words(const epoint &p, const unsigned int *words, int count, epoint &res);
+
+	/* Fixed-base routines */
+	static int comb_precompute(fbpoint &p);
+
+	/* Point halving routines */
+	static bool can_halve(const epoint &p);
+	static void halve_lambda(const ecurve &curve, const lnum &u, const lnum &lambdaU, lnum &x, lnum &lambda);
+
+	/* Frobenius endomorphism routines */
+	static bool can_frobenius(const epoint &p);
+	static void tnaf_setup(ecurve &curve);
+	static void tnaf_round_div(int mu, const bint &k0, const bint &k1, const bint &s0, const bint &s1, const bint &norm, bint &r0, bint &r1);
+	static int tnaf_recode(int mu, int w, int t, const int (*alpha)[2], const bint &k0, const bint &k1, signed char *digits);
+	static int tnaf_precompute(const epoint &p, int w, epoint *table);
+
+	/* Montgomery ladder routines */
+	static void ladder_words(const ecurve &curve, const lnum &x, const unsigned int *words, int count, lnum &X1, lnum &Z1, lnum &X2, lnum &Z2);
 
 	friend class epoint;
+	friend class fbpoint;
+	friend class ecurve;
 };
 
 #endif
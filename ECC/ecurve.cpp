@@ -5,6 +5,7 @@
 #include "2nfactory.h"
 #include "bint.h"
 #include "bintoperations.h"
+#include "eccoperations.h"
 
 /* Constructors */
 
@@ -14,12 +15,18 @@ ecurve::ecurve(const lnum &a, const lnum &b, int nf, const bfactor *bf) : a(a),
 	int res, i;
 	if ((res = lnumOperations::belong_to_same_nonzero_field(a, b)) < 0) lnumRoutines::op_err(res);
 	field = &a.get_field();
+	mulMethod = pMulDoubling;
+	curveOrderKnown = false;
+	orderCacheCount = orderCacheNext = 0;
 
 	if (nf < 0) nf = 0;
 	nfac = nf;
 	if (nfac != 0) factor = new bfactor[nfac]; else factor = 0;
 	for (i = 0; i < nfac; i++)
 		factor[i] = bf[i];
+
+	// Frobenius map makes tau-adic multiplication the fastest method, where it is available.
+	if (is_koblitz()) set_mul_method(pMulFrobenius);
 }
 
 /* Destructors */
@@ -173,11 +180,62 @@ int ecurve::unpack(const lnum &poly, epoint &res) const
 	return pE_OK;
 }
 
+// Unpacks count points from given polynoms (same format as unpack) and saves them to res.
+// Equations of every pBatchLen points are solved together, sharing one field division.
+// Returns error code, indicating result of the operation.
+int ecurve::unpack_n(const lnum *polys, int count, epoint *res) const
+{
+	int i, j, n;
+	if (count <= 0) return pE_OK;
+	for (i = 0; i < count; i++)
+		if (!is_over_field(polys[i].get_field())) return pE_DIFFFIELD;
+
+	const gf2n &field = get_field();
+	int fieldDegree = field.get_deg();
+	lnum *x = new lnum[4 * pBatchLen];
+	lnum *c = x + pBatchLen, *u = c + pBatchLen, *v = u + pBatchLen;
+	bool *secondSolution = new bool[pBatchLen];
+	int result = pE_OK;
+	for (i = 0; i < count && result == pE_OK; i += n)
+	{
+		n = min(pBatchLen, count - i);
+		for (j = 0; j < n; j++)
+		{
+			x[j] = polys[i + j];
+			secondSolution[j] = x[j][fieldDegree];
+			if (secondSolution[j]) x[j].set_bit(fieldDegree);
+			lnum t = lnumOperations::sqr(x[j]);
+			c[j] = b + a * t + t * x[j];
+			u[j] = lnum(field);
+			v[j] = lnum(field);
+		}
+		if (lnumOperations::solve_quadratic_n(x, c, n, u, v) != lE_OK)
+		{
+			result = pE_UNPACKERROR;
+			break;
+		}
+		for (j = 0; j < n; j++)
+		{
+			if (secondSolution[j] && x[j].is_zero()) res[i + j] = epoint(*this);
+			else res[i + j] = epoint(x[j], secondSolution[j] ? v[j] : u[j], *this);
+		}
+	}
+	delete [] secondSolution;
+	delete [] x;
+	return result;
+}
+
 /* Order calculation methods */
 
 // Calculates elliptic curves order and saves result to big integer res.
+// Order is computed once and cached. Not thread-safe: the first call must not run in several threads at once.
 void ecurve::order(bint &res) const
 {
+	if (curveOrderKnown)
+	{
+		res = curveOrder;
+		return;
+	}
 	bint c0(2), c1, cr, aa;
 	int i;
 	int ct = 0;
@@ -202,6 +260,8 @@ void ecurve::order(bint &res) const
 	}
 	if (ct = bintOperations::pow(bint(2), fieldPower, res)) bintRoutines::op_err(ct);
 	res += bint(1) - cr;
+	curveOrder = res;
+	curveOrderKnown = true;
 }
 
 #ifdef _ECURVE_ORDER_DUMB
@@ -234,15 +294,108 @@ void ecurve::order_dumb(bint &res) const
 }
 #endif
 
+/* Order cache */
+
+// Looks up cached order of point p. Returns true and saves the order to res if it is found, otherwise - false.
+bool ecurve::find_order(const epoint &p, bint &res) const
+{
+	int i;
+	for (i = 0; i < orderCacheCount; i++)
+		if (orderCache[i].x == p.x && orderCache[i].y == p.y)
+		{
+			res = orderCache[i].order;
+			return true;
+		}
+	return false;
+}
+
+// Caches order of point p, replacing the oldest cached one, if cache is full.
+void ecurve::store_order(const epoint &p, const bint &order) const
+{
+	orderCache[orderCacheNext].x = p.x;
+	orderCache[orderCacheNext].y = p.y;
+	orderCache[orderCacheNext].order = order;
+	orderCacheNext = (orderCacheNext + 1) % pOrderCache;
+	if (orderCacheCount < pOrderCache) orderCacheCount++;
+}
+
 /* Setter methods */
 
+// Sets curves order factorization. Cached point orders are dropped.
 void ecurve::set_factor(int nf, const bfactor *bf)
 {
 	int i;
 
+	delete [] factor;
 	if (nf < 0) nf = 0;
 	nfac = nf;
 	if (nfac != 0) factor = new bfactor[nfac]; else factor = 0;
 	for (i = 0; i < nfac; i++)
 		factor[i] = bf[i];
+	orderCacheCount = orderCacheNext = 0;
+}
+
+/* Scalar multiplication configuration */
+
+// Returns true if point halving can be used on this curve (field degree is odd and Tr(a) = 1), otherwise - false.
+// On such curves #E = 2 * n with odd n and halving is unique within the subgroup of order n.
+bool ecurve::supports_halving(void) const
+{
+	return (field->get_deg() & 1) && a.trace();
+}
+
+// Returns true if curve is a Koblitz curve (a and b lie in GF(2)), otherwise - false.
+// On such curves Frobenius map tau(x, y) = (x^2, y^2) is an endomorphism, satisfying tau^2 - mu * tau + 2 = 0.
+bool ecurve::is_koblitz(void) const
+{
+	return (a.is_zero() || a.is_one()) && b.is_one();
+}
+
+// Selects scalar multiplication method (one of pMul* constants) used by eccOperations::mul for points of this curve.
+// Halving needs curves order factorization, unless the curve is a Koblitz curve.
+// Returns error code, indicating completion result.
+int ecurve::set_mul_method(int method)
+{
+	switch (method)
+	{
+	case pMulDoubling :
+		break;
+	case pMulHalving :
+	{
+		if (!supports_halving()) return pE_NOHALVING;
+		bint n(1), t;
+		bool inf;
+		int i, r;
+		lnum x(*field);
+		// Halving recodes scalars modulo the odd order. Curves order is the product of its factorization: order() counts points
+		// of subfield curves only, and the only subfield curves with halving are Koblitz curves.
+		if (nfac > 0)
+			for (i = 0; i < nfac; i++)
+			{
+				if (r = bintOperations::pow(factor[i].p, factor[i].k, t)) bintRoutines::op_err(r);
+				n = n * t;
+			}
+		else if (is_koblitz()) order(n);
+		else return pE_NOHALVING;
+		// Make sure the order is right: a random point must vanish.
+		if (eccOperations::mul_x(random_point(), n, x, inf) || !inf) return pE_NOHALVING;
+		oddOrder = n / 2;
+		if (!oddOrder.is_odd()) return pE_NOHALVING;
+		break;
+	}
+	case pMulFrobenius :
+		if (!is_koblitz()) return pE_NOFROBENIUS;
+		eccOperations::tnaf_setup(*this);
+		break;
+	default :
+		return pE_UNASSIGNED;
+	}
+	mulMethod = method;
+	return pE_OK;
+}
+
+// Returns scalar multiplication method used for points of this curve.
+int ecurve::get_mul_method(void) const
+{
+	return mulMethod;
 }
@@ -19,6 +19,13 @@ typedef struct
 	int k;  // factors power
 } bfactor;
 
+// Struct used to cache point order.
+typedef struct
+{
+	lnum x, y;  // points cordinates
+	bint order; // points order
+} porder;
+
 class ecurve
 {
 	/* Constructors */
@@ -46,6 +53,7 @@ public:
 
 	/* Packing methods */
 	int unpack(const lnum &poly, epoint &res) const;
+	int unpack_n(const lnum *polys, int count, epoint *res) const;
 
 	/* Order calculation methods */
 	void order(bint &res) const;
@@ -56,6 +64,12 @@ public:
 	/* Setter methods */
 	void set_factor(int nf, const bfactor *bf);
 
+	/* Scalar multiplication configuration */
+	bool supports_halving(void) const;
+	bool is_koblitz(void) const;
+	int set_mul_method(int method);
+	int get_mul_method(void) const;
+
 private:
 	lnum a, b;
 	const gf2n *field;
@@ -63,6 +77,26 @@ private:
 	bfactor *factor;
 	int nfac;
 
+	/* Order cache */
+	bool find_order(const epoint &p, bint &res) const;
+	void store_order(const epoint &p, const bint &order) const;
+
+	// Caches are written by const methods without locks (see order and epoint::order).
+	mutable bint curveOrder;                 // curves order, valid when curveOrderKnown is set
+	mutable bool curveOrderKnown;
+	mutable porder orderCache[pOrderCache];  // orders of recently used points
+	mutable int orderCacheCount, orderCacheNext;
+
+	int mulMethod;  // one of pMul* constants
+	bint oddOrder;  // order of odd-order subgroup (#E / 2), set when halving is selected
+
+	// Tau-adic NAF parameters of Koblitz curves, set when Frobenius method is selected.
+	int tauMu;                                       // tau^2 = mu * tau - 2, mu = (-1)^(1 - a)
+	bint tauModule[2];                               // tau^m - 1 = tauModule[0] + tauModule[1] * tau, scalars are reduced modulo it
+	bint tauNorm;                                    // norm of tau^m - 1, equals #E
+	int tauT[pNafMaxWidth + 1];                           // tau maps to tauT[w] in Z[tau] / (tau^w) = Z / 2^w
+	int tauAlpha[pNafMaxWidth + 1][1 << (pNafMaxWidth - 2)][2];  // alpha_u = u mods tau^w = tauAlpha[w][u / 2][0] + tauAlpha[w][u / 2][1] * tau
+
 	friend class epoint;
 	friend class eccOperations;
 	// WTF is this anyway??
@@ -58,6 +58,17 @@ int epoint::f(int arg) const
 	return a[0] & arg;
 }
 
+// Returns hash value of x cordinate of a given point (FNV-1a over its words), so X and -X have the same hash.
+// Unlike f, it depends on all bits of x.
+unsigned int epoint::hash(void) const
+{
+	unsigned int *a = x.to_int();
+	unsigned int h = 2166136261u;
+	for (int i = 0, l = x.deg() / lbLen; i <= l; i++)
+		h = (h ^ a[i]) * 16777619u;
+	return h;
+}
+
 /* Accessor methods */
 
 // Returns x cordinate of a given point.
@@ -105,6 +116,22 @@ void epoint::assign(const ecurve *ec)
 	curve = ec;
 }
 
+// Replaces the point by the representative of its class {P, -P}: the one, whose y has zero bit at the lowest non-zero bit of x
+// (negation adds x to y, so it flips this bit). Returns true if the point was negated.
+bool epoint::canonize(void)
+{
+	const unsigned int *a = x.to_int();
+	const unsigned int *b = y.to_int();
+	for (int i = 0; i < lLen; i++)
+		if (a[i] != 0)
+		{
+			if ((b[i] & a[i] & (0u - a[i])) == 0) return false;
+			y += x;
+			return true;
+		}
+	return false;
+}
+
 /* Helper methods */
 
 /*void cycle_sum(const epoint &what, bint times, epoint &res)
@@ -129,30 +156,64 @@ void epoint::assign(const ecurve *ec)
 }*/
 
 // Calculates elliptic curve points order and saves it to big integer res.
+// Uses curves order factorization (prime powers q_i = p_i ^ k_i); part of curves order, not covered by it, is kept in the result as is.
+// Orders are cached by the curve, so repeated calls for the same point cost nothing.
+// Not thread-safe: the cache is written without locks, so threads must not compute orders of points of the same curve at once.
 void epoint::order(bint &res) const
 {
 	if (curve == 0) eccRoutines::op_err(pE_UNASSIGNED);
+	if (curve->find_order(*this, res)) return;
 	curve->order(res);
-	//std::cout << "ord: " << res << std::endl;
-	//curve->order_dumb(res);
-	int i;
-	bint t;
-	epoint p(*curve), p2(*curve);
-	for (i = 0; i < curve->nfac; i++)
+	int i, r, n = curve->nfac;
+	if (n > 0)
 	{
-		bintOperations::pow(curve->factor[i].p, curve->factor[i].k, t);
-		res = res / t;
-		//std::cout << "res: " << res << std::endl;
-		eccOperations::mul(*this, res, p);
-		//cycle_sum(*this, res, p);
-		while (!p.is_inf())
+		bint *primes = new bint[n];
+		bint *powers = new bint[n];
+		for (i = 0; i < n; i++)
 		{
-			eccOperations::mul(p, curve->factor[i].p, p2); p = p2;
-			//cycle_sum(p, curve->factor[i].p, p2);
-			p = p2;
-			res = res * curve->factor[i].p;
+			primes[i] = curve->factor[i].p;
+			if (r = bintOperations::pow(primes[i], curve->factor[i].k, powers[i])) bintRoutines::op_err(r);
+			res = res / powers[i];
 		}
+		lnum px(x);
+		bool inf = is_inf();
+		if (!inf && !res.is_one()) eccOperations::mul_x(*this, res, px, inf);
+		if (!inf) order_split(px, primes, powers, 0, n, res);
+		delete [] primes;
+		delete [] powers;
 	}
+	curve->store_order(*this, res);
+}
+
+/* Order calculation methods */
+
+// Multiplies res by order of a finite point of curve with x cordinate x, which must divide product of powers[l..r - 1] (powers[i] = primes[i] ^ k_i).
+// Product tree: the point is multiplied by the product of one half of prime powers, which leaves only the other halfs part of the order,
+// so every level of recursion costs two scalar multiplications, and a single prime power is resolved by at most k_i multiplications by p_i.
+// Only infinity tests are needed, so x-only ladder is enough (P and -P have the same order).
+void epoint::order_split(const lnum &x, const bint *primes, const bint *powers, int l, int r, bint &res) const
+{
+	bool inf = false;
+	lnum q(x);
+	if (r - l == 1)
+	{
+		while (!inf)
+		{
+			eccOperations::mul_x(*curve, q, primes[l], q, inf);
+			res = res * primes[l];
+		}
+		return;
+	}
+	int i, mid = (l + r) / 2;
+	bint left(1), right(1);
+	for (i = l; i < mid; i++)
+		left = left * powers[i];
+	for (i = mid; i < r; i++)
+		right = right * powers[i];
+	eccOperations::mul_x(*curve, x, right, q, inf);
+	if (!inf) order_split(q, primes, powers, l, mid, res);
+	eccOperations::mul_x(*curve, x, left, q, inf);
+	if (!inf) order_split(q, primes, powers, mid, r, res);
 }
 
 /* Packing methods */
@@ -183,6 +244,52 @@ int epoint::pack(lnum &res) const
 	return pE_OK;
 }
 
+// Packs count points of the same curve into polynoms res (same format as pack).
+// Equations of every pBatchLen points are solved together, sharing one field division.
+// Returns error code, indicating result of the operation.
+int epoint::pack_n(const epoint *points, int count, lnum *res)
+{
+	int i, j, n;
+	if (count <= 0) return pE_OK;
+	const ecurve *ourCurve = points[0].curve;
+	if (ourCurve == 0) return pE_UNASSIGNED;
+	for (i = 0; i < count; i++)
+		if (points[i].curve != ourCurve) return pE_DIFFCURVES;
+
+	const gf2n &field = ourCurve->get_field();
+	int fieldDegree = field.get_deg();
+	lnum *c = new lnum[4 * pBatchLen];
+	lnum *b = c + pBatchLen, *u = b + pBatchLen, *v = u + pBatchLen;
+	int result = pE_OK;
+	for (i = 0; i < count && result == pE_OK; i += n)
+	{
+		n = min(pBatchLen, count - i);
+		for (j = 0; j < n; j++)
+		{
+			const epoint &p = points[i + j];
+			b[j] = p.x;
+			c[j] = lnumOperations::sqr(p.x);
+			c[j] = c[j] * p.x + ourCurve->a * c[j] + ourCurve->b;
+			u[j] = lnum(field);
+			v[j] = lnum(field);
+		}
+		if (lnumOperations::solve_quadratic_n(b, c, n, u, v) != lE_OK)
+		{
+			result = pE_PACKERROR;
+			break;
+		}
+		for (j = 0; j < n; j++)
+		{
+			const epoint &p = points[i + j];
+			res[i + j] = p.x;
+			if (p.is_inf() || v[j] == p.y) res[i + j].set_bit(fieldDegree);
+			else if (!(u[j] == p.y)) result = pE_PACKERROR;
+		}
+	}
+	delete [] c;
+	return result;
+}
+
 /* Data marking methods */
 
 // Unmarks data from current elliptic point and saves in to polynom res.
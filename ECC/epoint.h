@@ -22,6 +22,7 @@ public:
 	bool is_inf(void) const;
 	bool check(void) const;
 	int f(int arg) const;
+	unsigned int hash(void) const;
 
 	/* Accessor methods */
 	lnum get_x(void) const;
@@ -33,6 +34,7 @@ public:
 	/* Setter methods */
 	void inf(void);
 	void assign(const ecurve *ec);
+	bool canonize(void);
 
 	/* Helper methods */
 	void order(bint &res) const;
@@ -40,6 +42,7 @@ public:
 	/* Packing methods */
 	int pack_info(void) const;
 	int pack(lnum &res) const;
+	static int pack_n(const epoint *points, int count, lnum *res);
 
 	/* Data marking methods */
 	void unmark(lnum &res) const;
@@ -56,6 +59,9 @@ public:
 	epoint operator- (void) const;
 
 private:
+	/* Order calculation methods */
+	void order_split(const lnum &x, const bint *primes, const bint *powers, int l, int r, bint &res) const;
+
 	lnum x, y;
 	const ecurve *curve;
 
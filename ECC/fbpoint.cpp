@@ -0,0 +1,157 @@
+#include "fbpoint.h"
+#include "epoint.h"
+#include "ecurve.h"
+#include "eccoperations.h"
+#include "2nfactory.h"
+
+/* Constructors */
+
+// Creates a new instance of fixed-base point (attached to no curve, no tables).
+fbpoint::fbpoint(void)
+{
+	budget = pCombBudget;
+	table = 0;
+	clear();
+}
+
+// Creates a new instance of fixed-base point by copying point p together with its tables.
+fbpoint::fbpoint(const fbpoint &p) : base(p.base)
+{
+	table = 0;
+	(*this) = p;
+}
+
+// Creates a new instance of fixed-base point with base point base and precomputes its tables within budget bytes.
+fbpoint::fbpoint(const epoint &base, int budget)
+{
+	table = 0;
+	assign(base, budget);
+}
+
+/* Destructors */
+
+// Releases precomputed tables.
+fbpoint::~fbpoint()
+{
+	clear();
+}
+
+/* Helper methods */
+
+// Returns true if comb tables are precomputed, otherwise - false.
+bool fbpoint::is_precomputed(void) const
+{
+	return table != 0;
+}
+
+/* Accessor methods */
+
+// Returns base point.
+const epoint &fbpoint::get_base(void) const
+{
+	return base;
+}
+
+// Returns a constant pointer to a curve, which base point belongs to.
+const ecurve &fbpoint::get_curve(void) const
+{
+	return base.get_curve();
+}
+
+// Returns maximum scalar bit length served by comb tables (longer scalars fall back to generic multiplication).
+int fbpoint::get_bits(void) const
+{
+	return bits;
+}
+
+// Returns memory budget (in bytes) for comb tables.
+int fbpoint::get_budget(void) const
+{
+	return budget;
+}
+
+/* Setter methods */
+
+// Sets base point and precomputes its tables within current budget.
+void fbpoint::assign(const epoint &base)
+{
+	assign(base, budget);
+}
+
+// Sets base point and precomputes its tables within budget bytes.
+void fbpoint::assign(const epoint &base, int budget)
+{
+	int r;
+	clear();
+	this->base = base;
+	this->budget = budget;
+	if (base.is_inf()) return;
+
+	// Hasse bound: any reduced scalar fits into deg + 1 bits.
+	bits = base.get_curve().get_field().get_deg() + 1;
+	choose_layout();
+	if (!teeth) return;
+	if (r = eccOperations::comb_precompute(*this)) eccRoutines::op_err(r);
+}
+
+/* Operators */
+
+// Sets an instance of fixed-base point class (tables are copied).
+fbpoint& fbpoint::operator= (const fbpoint &p)
+{
+	int i, size;
+	if (&p == this) return *this;
+	clear();
+	base = p.base;
+	budget = p.budget;
+	bits = p.bits;
+	teeth = p.teeth;
+	span = p.span;
+	tables = p.tables;
+	step = p.step;
+	if (p.table)
+	{
+		size = tables * ((1 << teeth) - 1);
+		table = new epoint[size];
+		for (i = 0; i < size; i++) table[i] = p.table[i];
+	}
+	return *this;
+}
+
+/* Internal methods */
+
+// Chooses comb teeth and number of tables, minimizing doublings plus additions (a mixed addition costs about two doublings)
+// among layouts, which fit into memory budget. Leaves zero teeth, if budget is too small for any table.
+void fbpoint::choose_layout(void)
+{
+	int h, v, d, e, points;
+	int limit = budget / (int)sizeof(epoint);
+	double cost, bestCost = -1;
+	teeth = tables = span = step = 0;
+	for (h = 1; h < 16 && (1 << h) - 1 <= limit; h++)
+	{
+		d = (bits + h - 1) / h;
+		for (v = 1; v <= d; v++)
+		{
+			points = v * ((1 << h) - 1);
+			if (points > limit) break;
+			e = (d + v - 1) / v;
+			cost = e + 2.0 * v * e * (1.0 - 1.0 / (1 << h));
+			if (bestCost < 0 || cost < bestCost)
+			{
+				bestCost = cost;
+				teeth = h; tables = v;
+				span = d; step = e;
+			}
+		}
+	}
+}
+
+// Releases tables and resets layout.
+void fbpoint::clear(void)
+{
+	if (table) delete [] table;
+	table = 0;
+	bits = 0;
+	teeth = tables = span = step = 0;
+}
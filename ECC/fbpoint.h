@@ -0,0 +1,58 @@
+#ifndef _FBPOINT_H
+#define _FBPOINT_H
+
+#include "epoint.h"
+#include "eccdefines.h"
+
+/* Need some classes */
+class bint;
+class ecurve;
+class eccOperations;
+
+// Fixed-base point: elliptic point together with Lim-Lee comb tables of its multiples.
+// Scalar bits are arranged in a teeth x span matrix, split into several tables; each table holds all 2^teeth - 1 tooth combinations.
+// Multiplication by a scalar then takes only about span / tables doublings and span additions.
+class fbpoint
+{
+	/* Constructors */
+public:
+	fbpoint(void);
+	fbpoint(const fbpoint &p);
+	fbpoint(const epoint &base, int budget = pCombBudget);
+
+	/* Destructors */
+	~fbpoint();
+
+	/* Helper methods */
+	bool is_precomputed(void) const;
+
+	/* Accessor methods */
+	const epoint &get_base(void) const;
+	const ecurve &get_curve(void) const;
+	int get_bits(void) const;
+	int get_budget(void) const;
+
+	/* Setter methods */
+	void assign(const epoint &base);
+	void assign(const epoint &base, int budget);
+
+	/* Operators */
+	fbpoint& operator= (const fbpoint &p);
+
+private:
+	/* Internal methods */
+	void choose_layout(void);
+	void clear(void);
+
+	epoint base;
+	int budget;    // memory (in bytes) allowed for tables
+	int bits;      // maximum scalar length served by tables
+	int teeth;     // comb teeth (table index width)
+	int span;      // comb span: ceil(bits / teeth)
+	int tables;    // number of tables
+	int step;      // columns per table: ceil(span / tables)
+	epoint *table; // tables * (2^teeth - 1) affine points
+
+	friend class eccOperations;
+};
+#endif
@@ -124,18 +124,25 @@ namespace helpers
 	// Writes encrypted data to stream f.
 	bool output_encrypted_data(std::ostream &f, epoint *points, int point_count)
 	{
-		int i, l;
-		const char *values;
-		lnum x;
-		for (i = 0; i < point_count; i++)
+		int i, j, n, l;
+		if (point_count <= 0) return true;
+		l = points[0].get_curve().get_field().get_deg() + 1;
+		l = (l % lbLen != 0 ? l / lbLen + 1 : l / lbLen);
+		l *= lbLen / lbByte;
+		// Points are packed in batches of pBatchLen (one field division per batch).
+		lnum *x = new lnum[pBatchLen];
+		for (i = 0; i < point_count; i += n)
 		{
-			if (points[i].pack(x) < 0) return false;
-			values = (const char *)x.to_char();
-			l = x.get_field().get_deg() + 1;
-			l = (l % lbLen != 0 ? l / lbLen + 1 : l / lbLen);
-			l *= lbLen / lbByte;
-			f.write(values, l);
+			n = min(pBatchLen, point_count - i);
+			if (epoint::pack_n(points + i, n, x) < 0)
+			{
+				delete[] x;
+				return false;
+			}
+			for (j = 0; j < n; j++)
+				f.write((const char *)x[j].to_char(), l);
 		}
+		delete[] x;
 		return true;
 	}
 
@@ -179,6 +186,18 @@ namespace helpers
 		return point;
 	}
 
+	// Reads count packed points from stream and saves them to res (unpacked together).
+	void read_next_points(std::istream &f, const ecurve &curve, int count, epoint *res)
+	{
+		int i, r;
+		lnum *x = new lnum[count];
+		for (i = 0; i < count; i++)
+			x[i] = read_next_polynom(f, curve.get_field());
+		r = curve.unpack_n(x, count, res);
+		delete[] x;
+		if (r) eccRoutines::op_err(r);
+	}
+
 	// Reads data requiered for field creation from file and returns pointer to gf2n object.
 	gf2n *read_field(std::istream &f)
 	{
@@ -193,6 +212,7 @@ namespace helpers
 		lnum coefA = read_next_polynom(f, field);
 		lnum coefB = read_next_polynom(f, field);
 		int factorN;
+		ecurve *curve;
 		f >> factorN;
 		if (factorN == 0)
 			return new ecurve(coefA, coefB);
@@ -210,7 +230,11 @@ namespace helpers
 		}
 		delete[] str;
 		delete[] num;
-		return new ecurve(coefA, coefB, factorN, factors);
+		curve = new ecurve(coefA, coefB, factorN, factors);
+		// Halve-and-add beats double-and-add, where it is available (it needs the factorization to check curves order,
+		// Koblitz curves keep tau-adic method, selected by constructor).
+		if (curve->get_mul_method() == pMulDoubling && curve->supports_halving()) curve->set_mul_method(pMulHalving);
+		return curve;
 	}
 
 	// Reads all bytes from given stream till the end of file.
@@ -272,10 +296,7 @@ namespace helpers
 		key.zero();
 		bint half = ord / 2;
 		while (key.is_zero() || key < half)
-		{
-			key.random();
-			key = key % ord;
-		}
+			key.random_mod(ord);
 		return true;
 	}
 }
@@ -27,6 +27,7 @@ namespace helpers
 	lnum read_next_polynom(std::istream &f);
 	lnum read_next_polynom(std::istream &f, const gf2n &field);
 	epoint read_next_point(std::istream &f, const ecurve &curve);
+	void read_next_points(std::istream &f, const ecurve &curve, int count, epoint *res);
 	gf2n *read_field(std::istream &f);
 	ecurve *read_curve(std::istream &f, const gf2n &field);
 	unsigned char *read_till_end(std::istream &f, int &text_len);
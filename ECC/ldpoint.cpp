@@ -0,0 +1,107 @@
+#include "ldpoint.h"
+#include "epoint.h"
+#include "ecurve.h"
+#include "eccoperations.h"
+#include "2n.h"
+#include "2nfactory.h"
+
+/* Constructors */
+
+// Creates a new instance of projective point (attached to no curve).
+ldpoint::ldpoint(void)
+{
+	curve = 0;
+}
+
+// Creates a new instance of projective point by copying point p.
+ldpoint::ldpoint(const ldpoint &p) : X(p.X), Y(p.Y), Z(p.Z)
+{
+	curve = p.curve;
+}
+
+// Creates a new instance of projective infinity point, belonging to curve ec.
+ldpoint::ldpoint(const ecurve &ec) : X(ec.get_field()), Y(ec.get_field()), Z(ec.get_field())
+{
+	curve = &ec;
+	inf();
+}
+
+// Creates a new instance of projective point from affine point p.
+ldpoint::ldpoint(const epoint &p) : X(p.get_curve().get_field()), Y(p.get_curve().get_field()), Z(p.get_curve().get_field())
+{
+	from_affine(p);
+}
+
+/* Helper methods */
+
+// Returns true if a given point is infinity point, otherwise - false.
+bool ldpoint::is_inf(void) const
+{
+	return Z.is_zero();
+}
+
+/* Accessor methods */
+
+// Returns a constant pointer to a curve, which this point belongs to.
+const ecurve &ldpoint::get_curve(void) const
+{
+	return *curve;
+}
+
+/* Setter methods */
+
+// Sets given point to be infinity point (1 : 0 : 0).
+void ldpoint::inf(void)
+{
+	X.one();
+	Y.zero();
+	Z.zero();
+}
+
+/* Conversion methods */
+
+// Sets this point to affine point p: (x, y) -> (x : y : 1).
+void ldpoint::from_affine(const epoint &p)
+{
+	curve = &p.get_curve();
+	if (!Z.has_field())
+	{
+		// Default-constructed point: attach coordinates to curve's field.
+		X = Y = Z = lnum(curve->get_field());
+	}
+	if (p.is_inf())
+	{
+		inf();
+		return;
+	}
+	p.get_x(X);
+	p.get_y(Y);
+	Z.one();
+}
+
+// Converts this point to affine coordinates and saves it to res. Takes one field inversion.
+void ldpoint::to_affine(epoint &res) const
+{
+	int r;
+	if (r = eccOperations::to_affine(*this, res)) eccRoutines::op_err(r);
+}
+
+// Returns this point in affine coordinates.
+epoint ldpoint::to_affine(void) const
+{
+	epoint res(*curve);
+	to_affine(res);
+	return res;
+}
+
+/* Operators */
+
+// Sets an instance of projective point class.
+ldpoint& ldpoint::operator= (const ldpoint &p)
+{
+	X = p.X;
+	Y = p.Y;
+	Z = p.Z;
+	curve = p.curve;
+	return *this;
+}
@@ -0,0 +1,46 @@
+#ifndef _LDPOINT_H
+#define _LDPOINT_H
+
+#include "2n.h"
+#include "eccdefines.h"
+
+/* Need some classes */
+class ecurve;
+class epoint;
+class eccOperations;
+
+// Elliptic curve point in Lopez-Dahab projective coordinates (X : Y : Z), which stands for affine point (X / Z, Y / Z^2).
+// Points with Z = 0 are infinity points. Arithmetics in these coordinates needs no field inversions.
+class ldpoint
+{
+	/* Constructors */
+public:
+	ldpoint(void);
+	ldpoint(const ldpoint &p);
+	ldpoint(const ecurve &ec);
+	ldpoint(const epoint &p);
+
+	/* Helper methods */
+	bool is_inf(void) const;
+
+	/* Accessor methods */
+	const ecurve &get_curve(void) const;
+
+	/* Setter methods */
+	void inf(void);
+
+	/* Conversion methods */
+	void from_affine(const epoint &p);
+	void to_affine(epoint &res) const;
+	epoint to_affine(void) const;
+
+	/* Operators */
+	ldpoint& operator= (const ldpoint &p);
+
+private:
+	lnum X, Y, Z;
+	const ecurve *curve;
+
+	friend class eccOperations;
+};
+#endif
@@ -7,6 +7,7 @@
 #include "crypto.h"
 #include "2nfactory.h"
 #include "helpers.h"
+#include "prng.h"
 
 using namespace helpers;
 
@@ -40,7 +41,7 @@ void close_files(void)
 
 int main(void)
 {
-	srand((unsigned int)time(0));
+	prng::initialize(prng::default_seed());
 	open_files();
 	field = read_field(fin);
 	field->set_output_mode(FIELD_OUTPUT_MODE);
@@ -0,0 +1,165 @@
+#include "prng.h"
+#include <ctime>
+
+/* Static variables */
+
+unsigned long long prng::runSeed = PRNG_RUN_SEED;
+prng prng::globalGenerator;
+
+/* Constructors */
+
+// Creates a new generator with zero seed and stream.
+prng::prng(void)
+{
+	seed(0, 0);
+}
+
+// Creates a new generator for a given seed and stream.
+prng::prng(unsigned long long seed, unsigned long long stream)
+{
+	this->seed(seed, stream);
+}
+
+/* Setter methods */
+
+// Sets seed and stream of the generator and rewinds it to the beginning of the stream.
+void prng::seed(unsigned long long seed, unsigned long long stream)
+{
+	key[0] = (unsigned int)seed;
+	key[1] = (unsigned int)(seed >> 32);
+	counter[2] = (unsigned int)stream;
+	counter[3] = (unsigned int)(stream >> 32);
+	seek(0);
+}
+
+// Moves the generator to a given position (measured in 32-bit outputs) of its stream.
+void prng::seek(unsigned long long position)
+{
+	unsigned long long blockIndex = position / PRNG_BLOCK_LEN;
+	counter[0] = (unsigned int)blockIndex;
+	counter[1] = (unsigned int)(blockIndex >> 32);
+	generate_block();
+	used = (int)(position % PRNG_BLOCK_LEN);
+}
+
+/* Accessor methods */
+
+// Returns seed of the generator.
+unsigned long long prng::get_seed(void) const
+{
+	return ((unsigned long long)key[1] << 32) | key[0];
+}
+
+// Returns stream of the generator.
+unsigned long long prng::get_stream(void) const
+{
+	return ((unsigned long long)counter[3] << 32) | counter[2];
+}
+
+// Returns current position (measured in 32-bit outputs) of the generator in its stream.
+unsigned long long prng::tell(void) const
+{
+	unsigned long long blockIndex = ((unsigned long long)counter[1] << 32) | counter[0];
+	return blockIndex * PRNG_BLOCK_LEN + used;
+}
+
+/* Generator methods */
+
+// Returns next 32-bit random number.
+unsigned int prng::next(void)
+{
+	if (used == PRNG_BLOCK_LEN)
+	{
+		if (++counter[0] == 0) counter[1]++;
+		generate_block();
+		used = 0;
+	}
+	return block[used++];
+}
+
+// Returns a uniformly distributed random number from [0, n). Returns zero, if n is zero.
+// Multiplication maps a 32-bit number to the range, rejection removes the bias (Lemire's method), so no division is needed in most cases.
+unsigned int prng::next_below(unsigned int n)
+{
+	if (n == 0)
+		return 0;
+	unsigned long long m = (unsigned long long)next() * n;
+	unsigned int low = (unsigned int)m;
+	if (low < n)
+	{
+		unsigned int threshold = (0u - n) % n;
+		while (low < threshold)
+		{
+			m = (unsigned long long)next() * n;
+			low = (unsigned int)m;
+		}
+	}
+	return (unsigned int)(m >> 32);
+}
+
+// Returns a generator for an independent substream with a given index (e.g. process rank or thread number).
+// Substream number is derived by applying Philox to (index, stream), so it depends only on the seed, stream and index.
+prng prng::split(unsigned long long index) const
+{
+	unsigned int splitKey[2] = { key[0] ^ PRNG_W1, key[1] ^ PRNG_W0 };
+	unsigned int splitCounter[PRNG_BLOCK_LEN] = { (unsigned int)index, (unsigned int)(index >> 32), counter[2], counter[3] };
+	unsigned int result[PRNG_BLOCK_LEN];
+	philox(splitKey, splitCounter, result);
+	return prng(get_seed(), ((unsigned long long)result[1] << 32) | result[0]);
+}
+
+/* Run-wide generator */
+
+// Initializes the run-wide generator. Every process (or thread), that uses global generator, should pass its own stream.
+void prng::initialize(unsigned long long runSeed, unsigned long long stream)
+{
+	prng::runSeed = runSeed;
+	globalGenerator = prng(runSeed).split(stream);
+}
+
+// Returns PRNG_RUN_SEED if it is set, otherwise - a seed taken from current time.
+unsigned long long prng::default_seed(void)
+{
+	if (PRNG_RUN_SEED != 0)
+		return PRNG_RUN_SEED;
+	return ((unsigned long long)time(0) << 16) ^ (unsigned long long)clock();
+}
+
+// Returns seed of the current run.
+unsigned long long prng::get_run_seed(void)
+{
+	return runSeed;
+}
+
+// Returns the run-wide generator. It must not be shared between threads.
+prng &prng::global(void)
+{
+	return globalGenerator;
+}
+
+/* Internal methods */
+
+// Calculates Philox 4x32 block function for a given key and counter.
+void prng::philox(const unsigned int key[2], const unsigned int counter[PRNG_BLOCK_LEN], unsigned int result[PRNG_BLOCK_LEN])
+{
+	unsigned int k0 = key[0], k1 = key[1];
+	unsigned int c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+	for (int i = 0; i < PRNG_ROUNDS; i++)
+	{
+		unsigned long long p0 = (unsigned long long)PRNG_M0 * c0;
+		unsigned long long p1 = (unsigned long long)PRNG_M1 * c2;
+		c0 = (unsigned int)(p1 >> 32) ^ c1 ^ k0;
+		c2 = (unsigned int)(p0 >> 32) ^ c3 ^ k1;
+		c1 = (unsigned int)p1;
+		c3 = (unsigned int)p0;
+		k0 += PRNG_W0;
+		k1 += PRNG_W1;
+	}
+	result[0] = c0; result[1] = c1; result[2] = c2; result[3] = c3;
+}
+
+// Generates block of random numbers for current counter.
+void prng::generate_block(void)
+{
+	philox(key, counter, block);
+}
@@ -0,0 +1,51 @@
+#ifndef _PRNG_H
+#define _PRNG_H
+
+#include "prngdefines.h"
+
+// Counter-based pseudo random number generator (Philox 4x32-10).
+// The i-th output of a generator is a function of (seed, stream, i) only, so generators can be seeked
+// and split into independent streams (one per process, thread or walk) without any shared state.
+// A generator object itself is not thread-safe - every thread must use its own (split) generator.
+class prng
+{
+public:
+	/* Constructors */
+	prng(void);
+	prng(unsigned long long seed, unsigned long long stream = 0);
+
+	/* Setter methods */
+	void seed(unsigned long long seed, unsigned long long stream = 0);
+	void seek(unsigned long long position);
+
+	/* Accessor methods */
+	unsigned long long get_seed(void) const;
+	unsigned long long get_stream(void) const;
+	unsigned long long tell(void) const;
+
+	/* Generator methods */
+	unsigned int next(void);
+	unsigned int next_below(unsigned int n);
+	prng split(unsigned long long index) const;
+
+	/* Run-wide generator */
+	static void initialize(unsigned long long runSeed, unsigned long long stream = 0);
+	static unsigned long long default_seed(void);
+	static unsigned long long get_run_seed(void);
+	static prng &global(void);
+
+private:
+	/* Internal methods */
+	static void philox(const unsigned int key[2], const unsigned int counter[PRNG_BLOCK_LEN], unsigned int result[PRNG_BLOCK_LEN]);
+	void generate_block(void);
+
+	unsigned int key[2];
+	unsigned int counter[PRNG_BLOCK_LEN]; // counter[0..1] - block index, counter[2..3] - stream
+	unsigned int block[PRNG_BLOCK_LEN];
+	int used;
+
+	static unsigned long long runSeed;
+	static prng globalGenerator;
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef _PRNGDEFINES_H
+#define _PRNGDEFINES_H
+
+/****************************/
+/* prng class configuration */
+/****************************/
+
+// Seed of the whole run. Runs with the same non-zero seed reproduce the same random numbers.
+// Zero means that the seed is taken from current time.
+#define PRNG_RUN_SEED  0
+
+/*************************************/
+/* Enum-like constants configuration */
+/*************************************/
+/* Do not edit this                  */
+/*************************************/
+
+// Philox 4x32 round multipliers.
+#define PRNG_M0        0xD2511F53
+#define PRNG_M1        0xCD9E8D57
+
+// Philox 4x32 key schedule constants (golden ratio and sqrt(3) - 1).
+#define PRNG_W0        0x9E3779B9
+#define PRNG_W1        0xBB67AE85
+
+// Number of Philox rounds.
+#define PRNG_ROUNDS    10
+
+// Number of 32-bit words produced by one block.
+#define PRNG_BLOCK_LEN 4
+
+#endif
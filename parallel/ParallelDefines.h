@@ -12,14 +12,48 @@
 #define LOOP_SLEEP                    200
 
 // Number of random points in interation function
-#define PARALLEL_SET_COUNT            16
+#define PARALLEL_SET_COUNT            20
 
-// Mask for Pollard's partitioning function
-#define PARALLEL_SET_ARG              0xF
+// Number of interation function sets, that double points (Teske's mixed walk).
+#define PARALLEL_DOUBLING_COUNT       0
+
+// Pollard's partitioning function (one of POLLARD_PARTITION_* constants).
+#define PARALLEL_PARTITION            POLLARD_PARTITION_HASH
 
 // Minimum order to call sequential Pollard's algorithm instead of parallel one.
 #define PARALLEL_SEQUENTIAL_MIN_ORDER bint(240000000)
 
+// Walk mode used by slaves (one of PARALLEL_WALK_* constants).
+#define PARALLEL_WALK_MODE            PARALLEL_WALK_REPLAY
+
+// Slaves walk over classes {P, -P} (1 - yes, 0 - no), masters replay walks the same way.
+#define PARALLEL_NEGATION_MAP         1
+
+// Coefficient-free walk is restarted, if it made this many expected distinguished point distances without hitting one.
+#define PARALLEL_MAX_WALK_FACTOR      20
+
+// Initial capacity of masters' distinguished point store (it grows when needed).
+#define PARALLEL_DP_CAPACITY          4096
+
+/*************************************/
+/* Enum-like constants configuration */
+/*************************************/
+/* Do not edit this                  */
+/*************************************/
+
+// Walk mode: slaves update coefficients on every step and send them with distinguished points.
+#define PARALLEL_WALK_TRACKED         0
+
+// Walk mode: slaves send walks' seed and length with distinguished points and start a new walk, masters replay walks on collision.
+#define PARALLEL_WALK_REPLAY          1
+
+// Method: Pollard's rho-method in a prime-order subgroup.
+#define PARALLEL_METHOD_RHO           0
+
+// Method: kangaroo method in an interval holding the solution. Slaves are tame (even) and wild (odd) kangaroos,
+// they send tracked coefficients with distinguished points and restart only to jump off the trail of their own herd.
+#define PARALLEL_METHOD_KANGAROO      1
+
 /**********************************/
 /* MPI message tags configuration */
 /**********************************/
@@ -48,6 +82,9 @@
 // Collision solution message GROUP TAG
 #define PARALLEL_SOLUTION_GROUP              0x7C000000
 
+// Walk replay parameters message GROUP TAG
+#define PARALLEL_REPLAY_GROUP                0x7B000000
+
 // Integer length message TAG
 #define PARALLEL_LENGTH_TAG                  0x09000000
 
@@ -91,6 +128,9 @@
 // Abort message (when we just finish doing everything)
 #define PARALLEL_ABORT_CONTROL_MESSAGE      0x00003000
 
+// Jump message (when a kangaroo lands on the trail of its own herd, master tells it to jump ahead)
+#define PARALLEL_JUMP_CONTROL_MESSAGE       0x00004000
+
 /***************************/
 /* Constants configuration */
 /***************************/
@@ -4,9 +4,12 @@
 #include "ParallelMaster.h"
 #include "../ecc/ecurve.h"
 #include "../ecc/epoint.h"
+#include "../ecc/cpoint.h"
+#include "../ecc/eccoperations.h"
 #include "../ecc/2nfactory.h"
 #include "../ecc/2n.h"
 #include "../ecc/bint.h"
+#include "../ecc/prng.h"
 
 #ifdef WIN32
 #include <windows.h>
@@ -15,6 +18,7 @@
 #endif
 
 #include <iostream>
+#include <cstring>
 
 namespace ParallelHelpers
 {
@@ -54,7 +58,7 @@ namespace ParallelHelpers
 	inline int make_tag(void)
 	{
 		int source = identity->get_process_id() % (PARALLEL_TAG_SOURCE_PATTERN + 1);
-		int index = (rand() % PARALLEL_TAG_INDEX_PATTERN) + 1;
+		int index = prng::global().next_below(PARALLEL_TAG_INDEX_PATTERN) + 1;
 		return index | (source << PARALLEL_TAG_SOURCE_SHIFT);
 	}
 
@@ -134,13 +138,35 @@ namespace ParallelHelpers
 		send_lnum(curve.get_b(), process, PARALLEL_LNUM_TAG ^ mod);
 	}
 
-	// Sends elliptic curve to given process.
+	// Sends elliptic point to given process (compressed, as a single message).
 	void send_epoint(const epoint &point, int process, int pattern = PARALLEL_EPOINT_TAG)
 	{
-		int mod = extract_and_send_tag(process, pattern);
+		cpoint packed;
+		int res = packed.from_epoint(point);
+		if (res != pE_OK) eccRoutines::op_err(res);
+		send_cpoint(packed, point.get_curve().get_field(), process, pattern);
+	}
+
+	// Sends significant words of compact point to given process.
+	void send_cpoint(const cpoint &point, const gf2n &field, int process, int pattern = PARALLEL_EPOINT_TAG)
+	{
+		MPI_Send((void *)point.w, cpoint::words(field), MPI_UNSIGNED, process, pattern, MPI_COMM_WORLD);
+	}
 
-		send_lnum(point.get_x(), process, PARALLEL_LNUM_TAG ^ mod);
-		send_lnum(point.get_y(), process, PARALLEL_LNUM_TAG ^ mod);
+	// Sends count points of the same curve to given process (packed together, as a single message).
+	void send_epoints(const epoint *points, int count, int process, int pattern = PARALLEL_EPOINT_TAG)
+	{
+		int i, res;
+		const gf2n &field = points[0].get_curve().get_field();
+		int n = cpoint::words(field);
+		cpoint *packed = new cpoint[count];
+		unsigned int *buffer = new unsigned int[count * n];
+		if (res = cpoint::pack_n(points, count, packed)) eccRoutines::op_err(res);
+		for (i = 0; i < count; i++)
+			packed[i].store(buffer + i * n, field);
+		MPI_Send(buffer, count * n, MPI_UNSIGNED, process, pattern, MPI_COMM_WORLD);
+		delete [] buffer;
+		delete [] packed;
 	}
 
 	// Sends field with header to given process.
@@ -165,9 +191,8 @@ namespace ParallelHelpers
 		int mod = extract_and_send_tag(process, pattern);
 
 		int sign = num.get_sign();
-		int len = num.get_length();
-		const int *buf = num.get_ints() + len;
-		len = bLen + 1 - len;
+		const int *buf = num.get_ints();
+		int len = bLen + 1 - num.get_length();
 		MPI_Send(&sign, 1, MPI_INT, process, PARALLEL_LENGTH_TAG ^ mod, MPI_COMM_WORLD);
 		MPI_Send(&len, 1, MPI_INT, process, PARALLEL_LENGTH_TAG ^ mod, MPI_COMM_WORLD);
 		MPI_Send((void *)buf, len, MPI_INT, process, PARALLEL_BINT_TAG ^ mod, MPI_COMM_WORLD);
@@ -183,12 +208,14 @@ namespace ParallelHelpers
 	}
 
 	// Sends ParallelData structure information to process with ID process.
-	void send_ParallelData(int instance, const lnum &packedPoint, const bint &coefC, const bint &coefD, int process, int pattern = PARALLEL_PARALLELDATA_TAG)
+	// Coefficients coefC and coefD belong to the point length steps before packedPoint (zero, when they are tracked by the walk).
+	void send_ParallelData(int instance, const cpoint &packedPoint, const gf2n &field, const bint &coefC, const bint &coefD, int length, int process, int pattern = PARALLEL_PARALLELDATA_TAG)
 	{
 		int mod = extract_and_send_tag(process, pattern);
 
 		MPI_Send(&instance, 1, MPI_INT, process, PARALLEL_LENGTH_TAG ^ mod, MPI_COMM_WORLD);
-		ParallelHelpers::send_lnum(packedPoint, process, PARALLEL_LNUM_TAG ^ mod);
+		MPI_Send(&length, 1, MPI_INT, process, PARALLEL_LENGTH_TAG ^ mod, MPI_COMM_WORLD);
+		ParallelHelpers::send_cpoint(packedPoint, field, process, PARALLEL_EPOINT_TAG ^ mod);
 		ParallelHelpers::send_bint(coefC, process, PARALLEL_BINT_TAG ^ mod);
 		ParallelHelpers::send_bint(coefD, process, PARALLEL_BINT_TAG ^ mod);
 	}
@@ -205,7 +232,10 @@ namespace ParallelHelpers
 		bfactor *factors = new bfactor[length];
 		for (i = 0; i < length; i++)
 			factors[i] = receive_bfactor(process, PARALLEL_BFACTOR_TAG ^ mod);
-		ecurve *result = new ecurve(receive_lnum(process, field, PARALLEL_LNUM_TAG ^ mod), receive_lnum(process, field, PARALLEL_LNUM_TAG ^ mod), length, factors);	
+		// Coefficients must be received in the order they were sent (argument evaluation order is unspecified).
+		lnum a = receive_lnum(process, field, PARALLEL_LNUM_TAG ^ mod);
+		lnum b = receive_lnum(process, field, PARALLEL_LNUM_TAG ^ mod);
+		ecurve *result = new ecurve(a, b, length, factors);
 		delete [] factors;
 		return result;
 	}
@@ -275,27 +305,60 @@ namespace ParallelHelpers
 		return factor;
 	}
 
-	// Sends elliptic curve to given process.
+	// Receives elliptic point of curve curve and returns it.
 	epoint receive_epoint(int process, const ecurve &curve, int pattern = PARALLEL_EPOINT_TAG)
 	{
-		const gf2n &field = curve.get_field();
+		epoint result(curve);
+		int res = receive_cpoint(process, curve.get_field(), pattern).to_epoint(curve, result);
+		if (res != pE_OK) eccRoutines::op_err(res);
+		return result;
+	}
 
-		int mod = extract_and_receive_tag(process, pattern);
+	// Receives and returns a compact point over given field.
+	cpoint receive_cpoint(int process, const gf2n &field, int pattern = PARALLEL_EPOINT_TAG)
+	{
+		cpoint result;
+		int n = cpoint::words(field);
 
-		lnum x = receive_lnum(process, field, PARALLEL_LNUM_TAG ^ mod);
-		lnum y = receive_lnum(process, field, PARALLEL_LNUM_TAG ^ mod);
-		return epoint(x, y, curve);
+		MPI_Recv(result.w, n, MPI_UNSIGNED, process, pattern, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+		memset(result.w + n, 0, (pCompactLen - n) * sizeof(unsigned int));
+		return result;
+	}
+
+	// Receives count points of curve curve (sent by send_epoints) and saves them to res.
+	void receive_epoints(int process, const ecurve &curve, int count, epoint *res, int pattern = PARALLEL_EPOINT_TAG)
+	{
+		int i, r;
+		const gf2n &field = curve.get_field();
+		int n = cpoint::words(field);
+		cpoint *packed = new cpoint[count];
+		unsigned int *buffer = new unsigned int[count * n];
+		MPI_Recv(buffer, count * n, MPI_UNSIGNED, process, pattern, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+		for (i = 0; i < count; i++)
+			packed[i].load(buffer + i * n, field);
+		if (r = cpoint::unpack_n(curve, packed, count, res)) eccRoutines::op_err(r);
+		delete [] buffer;
+		delete [] packed;
 	}
 
 	// Receives ParallelData structure from ANY source.
 	ParallelData *receive_ParallelData(int process, const gf2n &field, int pattern = PARALLEL_PARALLELDATA_TAG)
 	{
 		ParallelData *result = new ParallelData;
+		MPI_Status status;
 
+		// All parts come from the process, that sent the tag: tags made by different processes may coincide.
+		if (extract_tag(pattern) == 0)
+		{
+			MPI_Probe(process, pattern, MPI_COMM_WORLD, &status);
+			process = status.MPI_SOURCE;
+		}
+		result->source = process;
 		int mod = extract_and_receive_tag(process, pattern);
 
 		MPI_Recv(&result->instance, 1, MPI_INT, process, PARALLEL_LENGTH_TAG ^ mod, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-		result->key = ParallelHelpers::receive_lnum(process, field, PARALLEL_LNUM_TAG ^ mod);
+		MPI_Recv(&result->length, 1, MPI_INT, process, PARALLEL_LENGTH_TAG ^ mod, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+		result->key = ParallelHelpers::receive_cpoint(process, field, PARALLEL_EPOINT_TAG ^ mod);
 		result->c = ParallelHelpers::receive_bint(process, PARALLEL_BINT_TAG ^ mod);
 		result->d = ParallelHelpers::receive_bint(process, PARALLEL_BINT_TAG ^ mod);
 		return result;
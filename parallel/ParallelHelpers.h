@@ -10,6 +10,7 @@ class ecurve;
 class gf2n;
 class lnum;
 class bint;
+struct cpoint;
 
 namespace ParallelHelpers
 {
@@ -33,11 +34,13 @@ namespace ParallelHelpers
 	// Communication commands
 	void send_ecurve(const ecurve &curve, int process, int pattern);
 	void send_epoint(const epoint &point, int process, int pattern);
+	void send_cpoint(const cpoint &point, const gf2n &field, int process, int pattern);
+	void send_epoints(const epoint *points, int count, int process, int pattern);
 	void send_gf2n(const gf2n &field, int process, int pattern);
 	void send_lnum(const lnum &x, int process, int pattern);
 	void send_bint(const bint &num, int process, int pattern);
 	void send_bfactor(const bfactor &factor, int process, int pattern);
-	void send_ParallelData(int instance, const lnum &packedPoint, const bint &coefC, const bint &coefD, int process, int pattern);
+	void send_ParallelData(int instance, const cpoint &packedPoint, const gf2n &field, const bint &coefC, const bint &coefD, int length, int process, int pattern);
 	ecurve *receive_ecurve(int process, const gf2n &field, int pattern);
 	gf2n *receive_gf2n(int process, int pattern);
 	lnum receive_lnum(int process, int pattern);
@@ -45,6 +48,8 @@ namespace ParallelHelpers
 	bint receive_bint(int process, int pattern);
 	bfactor receive_bfactor(int process, int pattern);
 	epoint receive_epoint(int process, const ecurve &curve, int pattern);
+	cpoint receive_cpoint(int process, const gf2n &field, int pattern);
+	void receive_epoints(int process, const ecurve &curve, int count, epoint *res, int pattern);
 	ParallelData *receive_ParallelData(int process, const gf2n &field, int pattern);
 }
 
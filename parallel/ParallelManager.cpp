@@ -6,11 +6,14 @@
 #include "../ecc/ecurve.h"
 #include "../ecc/crypto.h"
 #include "../ecc/helpers.h"
+#include "../ecc/prng.h"
 #include "../ecc/eccoperations.h"
 #include "../ecc/eccoperations.h"
+#include "../ecc/fbpoint.h"
 #include "../pollard/crack.h"
 #include "../pollard/crackdefines.h"
 #include <ctime>
+#include <cmath>
 
 /* ParallelManager class */
 
@@ -105,6 +108,32 @@ bool ParallelManager::solve(const epoint &G, const epoint &xG, bint &result, boo
 	char *time_string = new char[LINE_LEN];
 	bint order;
 	G.order(order);
+
+	// Keys are chosen from the upper half of G group (see helpers::choose_key), kangaroo method searches there,
+	// when it is expected to be faster than Pohlig-Hellman algorithm (see crack::set_solve_mode).
+	bint lo = order / 2, hi = order - bint(1);
+	int mode = crack::get_solve_mode();
+	if (mode == POLLARD_SOLVE_KANGAROO || (mode == POLLARD_SOLVE_AUTO &&
+		crackRoutines::kangaroo_steps(hi - lo + bint(1)) < crackRoutines::pohlig_hellman_steps(factors, factor_count, PARALLEL_NEGATION_MAP != 0)))
+	{
+		if (verbose) std::cout << offset << "[i] Solving in interval [" << lo << ", " << hi << "] by kangaroo method" << std::endl;
+		double kangaroo_time = 0;
+		bool solved = kangaroo(G, xG, order, lo, hi, result, kangaroo_time);
+		if (verbose)
+		{
+			sprintf(time_string, PRINT_FORMAT, kangaroo_time);
+			std::cout << offset << (solved ? "    [+] Success: " : "    [-] Fail: ") << time_string << " seconds." << std::endl;
+		}
+		if (solved || mode == POLLARD_SOLVE_KANGAROO)
+		{
+			delete [] factors;
+			delete [] time_string;
+			work_time = (clock() - work_time) / (double)CLOCKS_PER_SEC;
+			return solved;
+		}
+	}
+
+	fbpoint Gcomb(G);
 	for (i = 0; i < factor_count; i++)
 	{
 		if (verbose) std::cout << offset << "[i] Solving for prime-power subgroup (" << factors[i].p << " ^ " << factors[i].k << ")" << std::endl;
@@ -114,7 +143,7 @@ bool ParallelManager::solve(const epoint &G, const epoint &xG, bint &result, boo
 		bint temp_solution;
 		bint N = order /  factors[i].p;
 		epoint P(*curve), Q(*curve);
-		eccOperations::mul(G, N, P);
+		eccOperations::mul(Gcomb, N, P);
 		for (j = 0; j < factors[i].k; j++)
 		{
 			eccOperations::mul(temp, N, Q);
@@ -136,12 +165,13 @@ bool ParallelManager::solve(const epoint &G, const epoint &xG, bint &result, boo
 			}
 			if (!solved)
 			{
+				delete [] factors;
 				delete [] time_string;
 				return false;
 			}
 			bint temp_number = temp_solution * power;
 			factors[i].sol += temp_number;
-			eccOperations::mul(G, temp_number, Q);
+			eccOperations::mul(Gcomb, temp_number, Q);
 			temp -= Q;
 			power = power * factors[i].p;
 			N = N / factors[i].p;
@@ -151,6 +181,7 @@ bool ParallelManager::solve(const epoint &G, const epoint &xG, bint &result, boo
 	result = crackRoutines::chinese_remainder_theorem(factors, factor_count, order);
 	work_time = (clock() - work_time) / (double)CLOCKS_PER_SEC;
 
+	delete[] factors;
 	delete[] time_string;
 	return true;
 }
@@ -159,7 +190,6 @@ bool ParallelManager::solve(const epoint &G, const epoint &xG, bint &result, boo
 bool ParallelManager::pollard(const epoint &P, const epoint &Q, const bint &order, bint &result, double &work_time)
 {
 	work_time = clock();
-	int controlMessage = PARALLEL_NO_CONTROL_MESSAGE;
 
 	const ecurve &curve = P.get_curve();
 	if (!curve.belongs_to_curve(Q))
@@ -183,46 +213,87 @@ bool ParallelManager::pollard(const epoint &P, const epoint &Q, const bint &orde
 	// Generate iteration function to slaves
 	generate_interation_function(order, P, Q);
 	// Send everything to slaves
+	method = PARALLEL_METHOD_RHO;
 	send_pollard_parameters(order, P, Q);
 	
-	bool success = false;
-	int solutionInstance = 0;
+	bool success = wait_for_solution(result);
 
-	while (controlMessage != PARALLEL_ABORT_CONTROL_MESSAGE)
+	work_time = (clock() - work_time) / (double)CLOCKS_PER_SEC;
+	return success;
+}
+
+// Starts parallel kangaroo method for the solution known to lie in the interval [lo, hi]. Handle all data distribution.
+// Every slave is a kangaroo: even slaves are tame, odd ones are wild, so at least two slaves are needed. A kangaroo, that lands
+// on the trail of its own herd, is told by master to jump ahead by its offset point.
+bool ParallelManager::kangaroo(const epoint &P, const epoint &Q, const bint &order, const bint &lo, const bint &hi, bint &result, double &work_time)
+{
+	work_time = clock();
+
+	const ecurve &curve = P.get_curve();
+	if (!curve.belongs_to_curve(Q) || hi < lo)
 	{
-		if (controlMessage == PARALLEL_DONE_CONTROL_MESSAGE)
-		{
-			success = receive_solution(solutionInstance, result);
-			if (solutionInstance == instance)
-			{
-				send_control_message_to_all(PARALLEL_DONE_CONTROL_MESSAGE);
-				break;
-			}
-		}
-		controlMessage = ParallelHelpers::receive_control_message();
+		work_time = 0;
+		return false;
+	}
+
+	// Should we call sequential kangaroo method?
+	bint width = hi - lo + bint(1);
+	int slaves = identity.get_process_count() - master_count - 1;
+	if (width < PARALLEL_SEQUENTIAL_MIN_ORDER || slaves < 2)
+	{
+		int iterations;
+		return crack::kangaroo(P, Q, order, lo, hi, result, iterations, work_time);
 	}
 
+	// Tell everyone to start thier engines!
+	send_control_message_to_all(PARALLEL_INIT_CONTROL_MESSAGE);
+	// Mean jump lets herds meet in about 2 * sqrt(width) steps in total
+	double mean = max(1.0, slaves * sqrt(crackRoutines::to_double(width)) / 4);
+	generate_kangaroo_jumps(order, P, mean);
+	kangarooMiddle = (lo + width / bint(2)) % order;
+	kangarooSpread = crackRoutines::from_double(mean);
+	// Send everything to slaves
+	method = PARALLEL_METHOD_KANGAROO;
+	send_pollard_parameters(order, P, Q);
+
+	bool success = wait_for_solution(result);
+
 	work_time = (clock() - work_time) / (double)CLOCKS_PER_SEC;
 	return success;
 }
 
 /* Helper methods */
 
-// Sends iteration function to other processes
+// Sends iteration function to other processes (masters need it only to replay coefficient-free walks).
 void ParallelManager::send_iteration_function() const
 {
 	int process;
 	int count = identity.get_process_count();
 
+#if PARALLEL_WALK_MODE == PARALLEL_WALK_REPLAY
+	for (process = 1; process < count; process++)
+#else
 	for (process = master_count + 1; process < count; process++)
+#endif
 	{
 		int mod = ParallelHelpers::extract_and_send_tag(process, PARALLEL_ITERATION_FUNCTION_GROUP);
 		for (int i = 0; i < PARALLEL_SET_COUNT; i++)	
 		{
 			ParallelHelpers::send_bint(functionA[i], process, PARALLEL_BINT_TAG ^ mod);
 			ParallelHelpers::send_bint(functionB[i], process, PARALLEL_BINT_TAG ^ mod);
-			ParallelHelpers::send_epoint(functionR[i], process, PARALLEL_EPOINT_TAG ^ mod);
 		}
+		ParallelHelpers::send_epoints(functionR, PARALLEL_SET_COUNT, process, PARALLEL_EPOINT_TAG ^ mod);
+	}
+}
+
+// Sends points P and Q to masters, so they could replay coefficient-free walks.
+void ParallelManager::send_replay_parameters(const epoint &P, const epoint &Q) const
+{
+	for (int process = 1; process <= master_count; process++)
+	{
+		int mod = ParallelHelpers::extract_and_send_tag(process, PARALLEL_REPLAY_GROUP);
+		ParallelHelpers::send_epoint(P, process, PARALLEL_EPOINT_TAG ^ mod);
+		ParallelHelpers::send_epoint(Q, process, PARALLEL_EPOINT_TAG ^ mod);
 	}
 }
 
@@ -268,6 +339,8 @@ void ParallelManager::send_config(void) const
 }
 
 // Generates and sends initial points for slaves. It is done here, because we don't want to rely on slaves' random point generator.
+// In replay mode every slave also gets a random offset point, which is added to the seed to start a new walk.
+// Kangaroos get an offset v * P (0 < v <= spread) to jump ahead by, when they land on the trail of their herd.
 void ParallelManager::generate_and_send_initial_points(const bint &order, const epoint &P, const epoint &Q) const
 {
 	int process;
@@ -275,19 +348,57 @@ void ParallelManager::generate_and_send_initial_points(const bint &order, const
 	const ecurve &curve = P.get_curve();
 
 	epoint X(curve);
-	epoint tempPoint(curve);
 	bint c, d;
 
+	// Every walk start c * P + d * Q is computed jointly over comb tables of P and Q.
+	fbpoint combs[2];
+	bint scalars[2];
+	combs[0].assign(P);
+	combs[1].assign(Q);
 
 	for (process = master_count + 1; process < count; process++)
 	{
 		int mod = ParallelHelpers::extract_and_send_tag(process, PARALLEL_INITIAL_POINT_GROUP);
 
-		c.random(); c = c % order;
-		d.random(); d = d % order;
-		eccOperations::mul(P, c, X);
-		eccOperations::mul(Q, d, tempPoint);
-		X += tempPoint;
+		if (method == PARALLEL_METHOD_KANGAROO)
+		{
+			// Tame kangaroos start at (middle + u) * P, wild ones - at u * P + Q.
+			c.random_mod(kangarooSpread);
+			if ((process - master_count) % 2 == 0)
+			{
+				c = (kangarooMiddle + c) % order;
+				d.zero();
+			}
+			else
+				d = bint(1);
+		}
+		else
+		{
+			c.random_mod(order);
+			d.random_mod(order);
+		}
+		scalars[0] = c; scalars[1] = d;
+		eccOperations::mul(combs, scalars, 2, X);
+
+		ParallelHelpers::send_bint(c, process, PARALLEL_BINT_TAG ^ mod);
+		ParallelHelpers::send_bint(d, process, PARALLEL_BINT_TAG ^ mod);
+		ParallelHelpers::send_epoint(X, process, PARALLEL_EPOINT_TAG ^ mod);
+
+		if (method == PARALLEL_METHOD_KANGAROO)
+		{
+			c.random_mod(kangarooSpread);
+			c += bint(1);
+			d.zero();
+		}
+		else if (PARALLEL_WALK_MODE == PARALLEL_WALK_REPLAY)
+		{
+			c.random_mod(order);
+			d.random_mod(order);
+		}
+		else
+			continue;
+		scalars[0] = c; scalars[1] = d;
+		eccOperations::mul(combs, scalars, 2, X);
 
 		ParallelHelpers::send_bint(c, process, PARALLEL_BINT_TAG ^ mod);
 		ParallelHelpers::send_bint(d, process, PARALLEL_BINT_TAG ^ mod);
@@ -302,15 +413,23 @@ void ParallelManager::send_pollard_parameters(const bint &order, const epoint &P
 	int count = identity.get_process_count();
 
 	// Define instance - used in synchronization.
-	instance = (rand() % PARALLEL_MAX_INT) + 1;
+	instance = prng::global().next_below(PARALLEL_MAX_INT) + 1;
 
-	// Send instance to everyone
+	// Send instance and method to everyone
 	for (process = 1; process < count; process++)
+	{
 		MPI_Send((void *)&instance, 1, MPI_INT, process, PARALLEL_LENGTH_TAG, MPI_COMM_WORLD);
+		MPI_Send((void *)&method, 1, MPI_INT, process, PARALLEL_LENGTH_TAG, MPI_COMM_WORLD);
+	}
 
 	// Send iteration function to slaves
 	send_iteration_function();
 
+#if PARALLEL_WALK_MODE == PARALLEL_WALK_REPLAY
+	// Send points to masters
+	send_replay_parameters(P, Q);
+#endif
+
 	// Generate & send initial points for slaves
 	generate_and_send_initial_points(order, P, Q);
 
@@ -336,6 +455,29 @@ bool ParallelManager::receive_solution(int &solutionInstance, bint &solution) co
 	return result;
 }
 
+// Waits until a master reports the solution of the current instance, then stops everyone. Returns true if the solution is valid.
+bool ParallelManager::wait_for_solution(bint &solution)
+{
+	int controlMessage = PARALLEL_NO_CONTROL_MESSAGE;
+	bool success = false;
+	int solutionInstance = 0;
+
+	while (controlMessage != PARALLEL_ABORT_CONTROL_MESSAGE)
+	{
+		if (controlMessage == PARALLEL_DONE_CONTROL_MESSAGE)
+		{
+			success = receive_solution(solutionInstance, solution);
+			if (solutionInstance == instance)
+			{
+				send_control_message_to_all(PARALLEL_DONE_CONTROL_MESSAGE);
+				break;
+			}
+		}
+		controlMessage = ParallelHelpers::receive_control_message();
+	}
+	return success;
+}
+
 /* Internal methods */
 
 // Opens all needed file streams:
@@ -415,9 +557,11 @@ bool ParallelManager::read_input()
 	bint curveOrder;
 	curve->order(curveOrder);
 	std::cout << "[+] Created elliptic curve (order " << curveOrder << ")." << std::endl;
-	G = helpers::read_next_point(fin, *curve);
-	aG = helpers::read_next_point(fin, *curve);
-	bG = helpers::read_next_point(fin, *curve);
+	epoint points[3];
+	helpers::read_next_points(fin, *curve, 3, points);
+	G = points[0];
+	aG = points[1];
+	bG = points[2];
 	if (!G.check() || !aG.check() || !bG.check())
 	{
 		std::cout << "[-] Incorrect input data - points do not belong to curve => exiting." << std::endl;
@@ -426,19 +570,18 @@ bool ParallelManager::read_input()
 	return true;
 }
 
-// Generate random numbers and random points from group, which are used to define interation function.
+// Generate random numbers and random points from group, which are used to define interation function (see crackRoutines::generate_iteration_function).
 void ParallelManager::generate_interation_function(const bint &order, const epoint &P, const epoint &Q)
 {
-	const ecurve &curve = P.get_curve();
-	epoint tempPoint(curve);
+	fbpoint combs[2];
+	combs[0].assign(P);
+	combs[1].assign(Q);
+	crackRoutines::generate_iteration_function(combs, order, PARALLEL_SET_COUNT, functionR, functionA, functionB);
+}
 
-	for (int i = 0; i < PARALLEL_SET_COUNT; i++)
-	{
-		functionA[i].random();
-		functionA[i] = functionA[i] % order;
-		functionB[i].random(); functionB[i] = functionB[i] % order;
-		eccOperations::mul(P, functionA[i], functionR[i]);
-		eccOperations::mul(Q, functionB[i], tempPoint);
-		functionR[i] += tempPoint;
-	}
+// Generates jumps of kangaroo method of mean size mean, which are used as interation function (see crackRoutines::generate_kangaroo_jumps).
+void ParallelManager::generate_kangaroo_jumps(const bint &order, const epoint &P, double mean)
+{
+	fbpoint comb(P);
+	crackRoutines::generate_kangaroo_jumps(comb, order, mean, PARALLEL_SET_COUNT, functionR, functionA, functionB);
 }
\ No newline at end of file
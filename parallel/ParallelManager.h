@@ -4,6 +4,7 @@
 #include "ParallelPollard.h"
 #include "ParallelIdentity.h"
 #include "../ecc/epoint.h"
+#include "../ecc/bint.h"
 #include <iostream>
 
 // Need some classes
@@ -28,18 +29,22 @@ public:
 protected:
 	bool solve(const epoint &G, const epoint &xG, bint &result, bool verbose, char *offset, double &work_time);
 	bool pollard(const epoint &P, const epoint &Q, const bint &order, bint &result, double &work_time);
+	bool kangaroo(const epoint &P, const epoint &Q, const bint &order, const bint &lo, const bint &hi, bint &result, double &work_time);
 
 	/* Helper methods */
 	void send_iteration_function() const;
+	void send_replay_parameters(const epoint &P, const epoint &Q) const;
 	void send_control_message_to_all(int message) const;
 	void send_config(void) const;
 	void generate_and_send_initial_points(const bint &order, const epoint &P, const epoint &Q) const;
 	void send_pollard_parameters(const bint &order, const epoint &P, const epoint &Q);
 	bool receive_solution(int &solutionInstance, bint &solution) const;
+	bool wait_for_solution(bint &solution);
 
 private:
 	/* Internal methods */
 	void generate_interation_function(const bint &order, const epoint &P, const epoint &Q);
+	void generate_kangaroo_jumps(const bint &order, const epoint &P, double mean);
 	void open_files(char *input_filename, char *config_filename, char *encrypted_filename, char *output_filename);
 	void close_files();
 	bool read_config();
@@ -52,6 +57,10 @@ private:
 	epoint aG;
 	epoint bG;
 
+	// Kangaroo method: tame kangaroos start within kangarooSpread from kangarooMiddle, wild ones - from Q
+	bint kangarooMiddle;
+	bint kangarooSpread;
+
 	// Stream variables
 	std::ifstream fin;
 	std::ifstream fconfig;
@@ -3,6 +3,9 @@
 #include "ParallelDefines.h"
 #include "ParallelHelpers.h"
 #include "../ecc/bintoperations.h"
+#include "../ecc/eccoperations.h"
+#include "../pollard/crack.h"
+#include "../pollard/iterfunc.h"
 
 /* ParallelMaster class */
 
@@ -10,7 +13,7 @@
 
 // Main identity constructor
 ParallelMaster::ParallelMaster(const ParallelIdentity &identity)
-	: ParallelPollard(identity)
+	: ParallelPollard(identity), store(PARALLEL_DP_CAPACITY)
 {
 	receive_config();
 }
@@ -38,7 +41,7 @@ void ParallelMaster::run(void)
 		switch (controlMessage)
 		{
 		case PARALLEL_INIT_CONTROL_MESSAGE :
-			tree.Clear();
+			store.clear();
 			receive_pollard_parameters();
 			acceptPoints = true;
 			break;
@@ -50,21 +53,24 @@ void ParallelMaster::run(void)
 		if (acceptPoints && ParallelHelpers::have_incoming_message(PARALLEL_PARALLELDATA_TAG))
 		{
 			newPoint = ParallelHelpers::receive_ParallelData(MPI_ANY_SOURCE, *field, PARALLEL_PARALLELDATA_TAG);
-			if (newPoint->instance != instance)
-				delete newPoint;
-			else
+			if (newPoint->instance == instance)
 			{
-				Node<ParallelData *> *oldNode = tree.Add(newPoint);
-				if (oldNode != NULL)
+				// A walk, that passes its distinguished point again in a fruitless cycle, brings the same coefficients:
+				// such collision gives no solution and is skipped. A kangaroo, that followed the trail of its own herd, jumps ahead.
+				const dpentry *oldPoint = store.insert(newPoint->key, newPoint->c, newPoint->d, newPoint->length);
+				if (oldPoint != 0)
 				{
-					bool haveSolution = solve_congruence(newPoint->c, newPoint->d, oldNode->dat->c, oldNode->dat->d, result);
-					send_solution(haveSolution, result);
+					if (solve_collision(newPoint, oldPoint, result))
+						send_solution(true, result);
+					else if (method == PARALLEL_METHOD_KANGAROO)
+						ParallelHelpers::send_control_message(PARALLEL_JUMP_CONTROL_MESSAGE, newPoint->source);
 				}
 			}
+			delete newPoint;
 		}
 		controlMessage = ParallelHelpers::receive_control_message();
 	};
-	tree.Clear();
+	store.clear();
 }
 
 /* Helper methods */
@@ -82,7 +88,24 @@ void ParallelMaster::receive_config(void)
 void ParallelMaster::receive_pollard_parameters(void)
 {
 	MPI_Recv(&instance, 1, MPI_INT, MANAGER_RANK, PARALLEL_LENGTH_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+	MPI_Recv(&method, 1, MPI_INT, MANAGER_RANK, PARALLEL_LENGTH_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+#if PARALLEL_WALK_MODE == PARALLEL_WALK_REPLAY
+	receive_iteration_function();
+	receive_replay_parameters();
+#endif
 	groupOrder = ParallelHelpers::receive_bint(MANAGER_RANK, PARALLEL_BINT_TAG);
+#if PARALLEL_WALK_MODE == PARALLEL_WALK_REPLAY
+	create_iteration_function(groupOrder);
+#endif
+}
+
+// Receives points P and Q, which are required to replay coefficient-free walks.
+void ParallelMaster::receive_replay_parameters(void)
+{
+	int mod = ParallelHelpers::extract_and_receive_tag(MANAGER_RANK, PARALLEL_REPLAY_GROUP);
+
+	pointP = ParallelHelpers::receive_epoint(MANAGER_RANK, *curve, PARALLEL_EPOINT_TAG ^ mod);
+	pointQ = ParallelHelpers::receive_epoint(MANAGER_RANK, *curve, PARALLEL_EPOINT_TAG ^ mod);
 }
 
 // Notifies manager about completion of the algorithm (collision found) and sends found solution (if we have one) to the manager.
@@ -99,6 +122,30 @@ void ParallelMaster::send_solution(bool haveSolution, const bint &solution) cons
 		ParallelHelpers::send_bint(solution, MANAGER_RANK, PARALLEL_BINT_TAG ^ mod);
 }
 
+// Replays a walk of length steps from point c0 * P + d0 * Q and saves coefficients of its end to c and d.
+void ParallelMaster::replay_walk(const bint &c0, const bint &d0, int length, bint &c, bint &d) const
+{
+	c = c0;
+	d = d0;
+	if (length == 0)
+		return;
+
+	epoint X(*curve);
+	epoint points[2] = { pointP, pointQ };
+	bint scalars[2] = { c, d };
+	eccOperations::mul(points, scalars, 2, X);
+	crackRoutines::replay_walk(*function, length, X, c, d, PARALLEL_NEGATION_MAP != 0);
+}
+
+// Solves an equation for key determination from a received distinguished point and the stored one it collided with.
+bool ParallelMaster::solve_collision(const ParallelData *data, const dpentry *entry, bint &result) const
+{
+	bint c1, d1, c2, d2;
+	replay_walk(data->c, data->d, data->length, c1, d1);
+	replay_walk(entry->c, entry->d, entry->length, c2, d2);
+	return solve_congruence(c1, d1, c2, d2, result);
+}
+
 // Solves an equation for key determination from collision data.
 bool ParallelMaster::solve_congruence(bint c1, bint d1, bint c2, bint d2, bint &result) const
 {
@@ -4,19 +4,23 @@
 #include "ParallelPollard.h"
 #include "../ecc/bint.h"
 #include "../ecc/2n.h"
-#include "../AVL/AVLTree.h"
+#include "../ecc/epoint.h"
+#include "../ecc/cpoint.h"
+#include "../pollard/dpstore.h"
 
 // need some calsses
 class ParallelIdentiry;
 
-// Structure we use in the master to store infomation in the tree
+// Structure we receive distinguished points from slaves in
 typedef struct
 {
 public :
 	int instance;
-	lnum key;
+	int source; // process, that sent the point
+	cpoint key;
 	bint c;
 	bint d;
+	int length; // number of steps from point c * P + d * Q to the stored point
 } ParallelData;
 
 class ParallelMaster : public ParallelPollard
@@ -35,12 +39,19 @@ protected:
 	/* Helper methods */
 	void receive_config(void);
 	void receive_pollard_parameters(void);
+	void receive_replay_parameters(void);
 	void send_solution(bool haveSolution, const bint &solution) const;
+	void replay_walk(const bint &c0, const bint &d0, int length, bint &c, bint &d) const;
+	bool solve_collision(const ParallelData *data, const dpentry *entry, bint &result) const;
 	bool solve_congruence(bint c1, bint d1, bint c2, bint d2, bint &result) const;
 
 protected:
-	AVLTree<ParallelData *> tree;
+	dpstore store;
 	bint groupOrder;
+
+	// Points of ECDLP (used to replay coefficient-free walks)
+	epoint pointP;
+	epoint pointQ;
 };
 
 #endif
@@ -1,10 +1,13 @@
 #include "mpi.h"
 #include "ParallelPollard.h"
 #include "ParallelDefines.h"
+#include "ParallelHelpers.h"
 #include "../ecc/bint.h"
 #include "../ecc/epoint.h"
 #include "../ecc/ecurve.h"
 #include "../ecc/2nfactory.h"
+#include "../pollard/iterfunc.h"
+#include "../pollard/crackdefines.h"
 
 /* ParallelPollard class */
 
@@ -18,8 +21,10 @@ ParallelPollard::ParallelPollard(const ParallelIdentity &identity)
 	functionA = new bint[PARALLEL_SET_COUNT];
 	functionB = new bint[PARALLEL_SET_COUNT];
 	functionR = new epoint[PARALLEL_SET_COUNT];
+	function = 0;
 
 	instance = 0;
+	method = PARALLEL_METHOD_RHO;
 }
 
 /* Destructors */
@@ -33,6 +38,8 @@ ParallelPollard::~ParallelPollard()
 	delete [] functionA;
 	delete [] functionB;
 	delete [] functionR;
+	if (function != 0)
+		delete function;
 }
 
 /* Accessor methods */
@@ -49,3 +56,27 @@ const ParallelIdentity &ParallelPollard::get_identity(void) const
 void ParallelPollard::run(void)
 {
 }
+
+/* Helper methods */
+
+// Receives iteration function configuration from manager.
+void ParallelPollard::receive_iteration_function(void)
+{
+	int mod = ParallelHelpers::extract_and_receive_tag(MANAGER_RANK, PARALLEL_ITERATION_FUNCTION_GROUP);
+
+	for (int i = 0; i < PARALLEL_SET_COUNT; i++)
+	{
+		functionA[i] = ParallelHelpers::receive_bint(MANAGER_RANK, PARALLEL_BINT_TAG ^ mod);
+		functionB[i] = ParallelHelpers::receive_bint(MANAGER_RANK, PARALLEL_BINT_TAG ^ mod);
+	}
+	ParallelHelpers::receive_epoints(MANAGER_RANK, *curve, PARALLEL_SET_COUNT, functionR, PARALLEL_EPOINT_TAG ^ mod);
+}
+
+// Creates iteration function from the received one for a group of order order (kangaroos only jump, they never double).
+void ParallelPollard::create_iteration_function(const bint &order)
+{
+	if (function != 0)
+		delete function;
+	int doublings = method == PARALLEL_METHOD_KANGAROO ? 0 : PARALLEL_DOUBLING_COUNT;
+	function = new iterfunc(functionR, functionA, functionB, order, PARALLEL_SET_COUNT, doublings, PARALLEL_PARTITION);
+}
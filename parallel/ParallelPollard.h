@@ -9,6 +9,7 @@ class gf2n;
 class ecurve;
 class bint;
 class epoint;
+class iterfunc;
 
 class ParallelPollard
 {
@@ -25,6 +26,11 @@ public:
 	/* Worker methods */
 	virtual void run(void);
 
+protected:
+	/* Helper methods */
+	void receive_iteration_function(void);
+	void create_iteration_function(const bint &order);
+
 protected:
 	ParallelIdentity identity;
 	gf2n *field;
@@ -33,8 +39,10 @@ protected:
 	bint *functionA;
 	bint *functionB;
 	epoint *functionR;
+	iterfunc *function;
 
 	int instance;
+	int method;   // one of PARALLEL_METHOD_* constants
 };
 
 #endif
@@ -3,6 +3,8 @@
 #include "ParallelDefines.h"
 #include "ParallelHelpers.h"
 #include "../ecc/2nfactory.h"
+#include "../pollard/rhobatch.h"
+#include <cmath>
 
 /* ParallelSlave class */
 
@@ -24,6 +26,8 @@ ParallelSlave::~ParallelSlave()
 		delete [] conditionPrefixLength;
 	if (conditionPrefix != 0)
 		delete [] conditionPrefix;
+	if (walk != 0)
+		delete walk;
 }
 
 /* Worker methods */
@@ -34,8 +38,6 @@ void ParallelSlave::run(void)
 	int controlMessage = PARALLEL_NO_CONTROL_MESSAGE;
 	bool generatePoints = false;
 
-	lnum packedPoint;
-
 	while (controlMessage != PARALLEL_ABORT_CONTROL_MESSAGE)
 	{
 		switch (controlMessage)
@@ -47,6 +49,10 @@ void ParallelSlave::run(void)
 		case PARALLEL_DONE_CONTROL_MESSAGE :
 			generatePoints = false;
 			break;
+		case PARALLEL_JUMP_CONTROL_MESSAGE :
+			if (generatePoints && method == PARALLEL_METHOD_KANGAROO)
+				jump_ahead();
+			break;
 		}
 
 		if (generatePoints)
@@ -55,9 +61,12 @@ void ParallelSlave::run(void)
 			int masterInd = should_send();
 			if (masterInd > 0)
 			{
-				if (pointX.pack(packedPoint) == pE_OK)
-					ParallelHelpers::send_ParallelData(instance, packedPoint, coefC, coefD, masterInd, PARALLEL_PARALLELDATA_TAG);
+				send_point(masterInd);
+				if (replays_walks())
+					restart_walk();
 			}
+			else if (replays_walks() && walk->get_length(0) >= maxWalkLength)
+				restart_walk();
 		}
 		controlMessage = ParallelHelpers::receive_control_message();
 	};
@@ -70,6 +79,7 @@ void ParallelSlave::receive_config(void)
 {
 	conditionPrefix = 0;
 	conditionPrefixLength = 0;
+	walk = 0;
 
 	int mod = ParallelHelpers::extract_and_receive_tag(MANAGER_RANK, PARALLEL_CONFIG_GROUP);
 
@@ -82,19 +92,15 @@ void ParallelSlave::receive_config(void)
 	MPI_Recv((void *)conditionPrefixLength, master_count, MPI_INT, MANAGER_RANK, PARALLEL_LENGTH_TAG ^ mod, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 	for (int i = 0; i < master_count; i++)
 		conditionPrefix[i] = ParallelHelpers::receive_lnum(MANAGER_RANK, *field, PARALLEL_LNUM_TAG ^ mod);
-}
-
-// Receives iteration function configuration from manager.
-void ParallelSlave::receive_iteration_function(void)
-{
-	int mod = ParallelHelpers::extract_and_receive_tag(MANAGER_RANK, PARALLEL_ITERATION_FUNCTION_GROUP);
 
-	for (int i = 0; i < PARALLEL_SET_COUNT; i++)
-	{
-		functionA[i] = ParallelHelpers::receive_bint(MANAGER_RANK, PARALLEL_BINT_TAG ^ mod);
-		functionB[i] = ParallelHelpers::receive_bint(MANAGER_RANK, PARALLEL_BINT_TAG ^ mod);
-		functionR[i] = ParallelHelpers::receive_epoint(MANAGER_RANK, *curve, PARALLEL_EPOINT_TAG ^ mod);
-	}
+	// Expected distance between distinguished points limits the length of a coefficient-free walk.
+	double probability = 0;
+	for (int i = 0; i < master_count; i++)
+		probability += pow(2.0, -conditionPrefixLength[i]);
+	if (probability * PARALLEL_MAX_INT <= PARALLEL_MAX_WALK_FACTOR)
+		maxWalkLength = PARALLEL_MAX_INT;
+	else
+		maxWalkLength = (int)(PARALLEL_MAX_WALK_FACTOR / probability);
 }
 
 // Receives initial point from manager.
@@ -104,32 +110,92 @@ void ParallelSlave::receive_initial_point(void)
 
 	coefC = ParallelHelpers::receive_bint(MANAGER_RANK, PARALLEL_BINT_TAG ^ mod);
 	coefD = ParallelHelpers::receive_bint(MANAGER_RANK, PARALLEL_BINT_TAG ^ mod);
-	pointX = ParallelHelpers::receive_epoint(MANAGER_RANK, *curve, PARALLEL_EPOINT_TAG ^ mod);
+	walkStart = ParallelHelpers::receive_epoint(MANAGER_RANK, *curve, PARALLEL_EPOINT_TAG ^ mod);
+	if (PARALLEL_WALK_MODE == PARALLEL_WALK_REPLAY || method == PARALLEL_METHOD_KANGAROO)
+	{
+		offsetC = ParallelHelpers::receive_bint(MANAGER_RANK, PARALLEL_BINT_TAG ^ mod);
+		offsetD = ParallelHelpers::receive_bint(MANAGER_RANK, PARALLEL_BINT_TAG ^ mod);
+		offsetPoint = ParallelHelpers::receive_epoint(MANAGER_RANK, *curve, PARALLEL_EPOINT_TAG ^ mod);
+	}
+	else
+	{
+		offsetC.zero();
+		offsetD.zero();
+		offsetPoint = epoint(*curve);
+	}
 }
 
 // Receives all parameters required to start Pollard's algorithm
 void ParallelSlave::receive_pollard_parameters(void)
 {
 	MPI_Recv(&instance, 1, MPI_INT, MANAGER_RANK, PARALLEL_LENGTH_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+	MPI_Recv(&method, 1, MPI_INT, MANAGER_RANK, PARALLEL_LENGTH_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 	receive_iteration_function();
 	receive_initial_point();
 	groupOrder = ParallelHelpers::receive_bint(MANAGER_RANK, PARALLEL_BINT_TAG);
+	create_iteration_function(groupOrder);
+	start_walk();
+}
+
+// Starts the walk from initial point. In replay mode new walks' seeds follow, shifted by offset point received from manager,
+// kangaroos jump ahead by it. Kangaroos only jump forward, so they never walk over classes {P, -P}.
+void ParallelSlave::start_walk(void)
+{
+	if (walk != 0)
+		delete walk;
+	walk = new rhobatch(*function, 1, PARALLEL_NEGATION_MAP != 0 && method != PARALLEL_METHOD_KANGAROO);
+	walk->set_seed(walkStart, coefC, coefD, offsetPoint, offsetC, offsetD);
+	walk->restart(0);
 }
 
-// Generates next point in sequence
+// Generates next point in sequence (with negation map - next class, escaping fruitless cycles, see rhobatch).
 void ParallelSlave::generate_next_point(void)
-{
-	int setInd = pointX.f(PARALLEL_SET_ARG);
-	pointX += functionR[setInd];
-	coefC += functionA[setInd]; if (coefC >= groupOrder) coefC -= groupOrder;
-	coefD += functionB[setInd]; if (coefD >= groupOrder) coefD -= groupOrder;
+{
+	walk->step();
+}
+
+// Starts a new coefficient-free walk from the next seed.
+void ParallelSlave::restart_walk(void)
+{
+	walk->restart(0);
+}
+
+// Restarts the kangaroo just ahead of its current point (by offset point), off the trail of its herd (see rhobatch::advance_seed).
+void ParallelSlave::jump_ahead(void)
+{
+	walk->advance_seed(0);
+	walk->restart(0);
+}
+
+// Sends the current point to master master. In replay mode it goes with coefficients of walks' seed and walks' length,
+// otherwise - with its own coefficients.
+void ParallelSlave::send_point(int master)
+{
+	cpoint packedPoint;
+	bint c, d;
+	int length = 0;
+	if (replays_walks())
+	{
+		walk->get_start(0, c, d);
+		length = walk->get_length(0);
+	}
+	else
+		walk->get_coefficients(0, c, d);
+	if (packedPoint.from_epoint(walk->get_point(0)) == pE_OK)
+		ParallelHelpers::send_ParallelData(instance, packedPoint, *field, c, d, length, master, PARALLEL_PARALLELDATA_TAG);
+}
+
+// Returns true if walks are coefficient-free: they are restarted after every distinguished point (kangaroos keep jumping).
+bool ParallelSlave::replays_walks(void) const
+{
+	return PARALLEL_WALK_MODE == PARALLEL_WALK_REPLAY && method != PARALLEL_METHOD_KANGAROO;
 }
 
 // Returns ID of master to send current point to or zero if the point should not be sent.
 int ParallelSlave::should_send(void) const
 {
 	lnum x;
-	pointX.get_x(x);
+	walk->get_point(0).get_x(x);
 	int xDeg = x.deg();
 	unsigned int *xInts = x.to_int();
 	unsigned int *yInts;
@@ -7,6 +7,7 @@
 
 // Need some classes
 class ParallelIdentity;
+class rhobatch;
 
 class ParallelSlave : public ParallelPollard
 {
@@ -23,22 +24,33 @@ public:
 protected:
 	/* Helper methods */
 	void receive_config(void);
-	void receive_iteration_function();
 	void receive_initial_point(void);
 	void receive_pollard_parameters(void);
+	void start_walk(void);
 	void generate_next_point(void);
+	void restart_walk(void);
+	void jump_ahead(void);
+	void send_point(int master);
 	int should_send(void) const;
+	bool replays_walks(void) const;
 
 private:
 	int master_count;
 	int condition_prefix_length;
 
 	/* Generator variables */
-	epoint pointX;
+	rhobatch *walk;  // single walk (over classes {P, -P} with negation map)
+	epoint walkStart;
 	bint coefC;
 	bint coefD;
 	bint groupOrder;
 
+	/* Coefficient-free walk variables */
+	int maxWalkLength;
+	epoint offsetPoint;
+	bint offsetC;
+	bint offsetD;
+
 	// Communication network topology
 	lnum *conditionPrefix;
 	int *conditionPrefixLength;
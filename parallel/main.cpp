@@ -7,6 +7,7 @@
 #include "ParallelHelpers.h"
 #include "ParallelDefines.h"
 #include "config.h"
+#include "../ecc/prng.h"
 #include <ctime>
 
 ParallelPollard *pollard;
@@ -15,11 +16,20 @@ int main(int argc, char *argv[])
 {
 	int master_count;
 	int procID;
+	unsigned long long runSeed;
 
 	MPI_Init(&argc, &argv);
 	ParallelHelpers::initialize(new ParallelIdentity());
 	procID = ParallelHelpers::identity->get_process_id();
-	srand((unsigned int)time(0) * (procID + 1));
+
+	// All processes share the run seed, each of them uses its own stream.
+	if (procID == MANAGER_RANK)
+	{
+		runSeed = prng::default_seed();
+		std::cout << "[i] Random seed " << runSeed << "." << std::endl;
+	}
+	MPI_Bcast(&runSeed, 1, MPI_UNSIGNED_LONG_LONG, MANAGER_RANK, MPI_COMM_WORLD);
+	prng::initialize(runSeed, procID);
 
 	if (procID == MANAGER_RANK)
 	{
@@ -0,0 +1,150 @@
+#include "bsgstable.h"
+#include "crack.h"
+#include "crackdefines.h"
+#include "../ecc/eccoperations.h"
+#include <cmath>
+
+/* bsgstable class */
+
+/* Constructors */
+
+// Creates the table of baby steps of P in a group of order order, storing at most budget steps.
+bsgstable::bsgstable(const epoint &P, const bint &order, int budget)
+	: comb(P), order(order), stride(P.get_curve())
+{
+	int i, j, k;
+	m = (int)min((double)max(budget, 1), ceil(sqrt(crackRoutines::to_double(order) / 2)));
+	m = max(m, 1);
+	capacity = 16;
+	while (capacity < 2 * m)
+		capacity <<= 1;
+	tags = new unsigned int[capacity];
+	steps = new int[capacity];
+	for (i = 0; i < capacity; i++)
+		steps[i] = 0;
+	eccOperations::mul(comb, bint(2 * m), stride);
+
+	// Baby steps j * P: a batch of consecutive steps goes ahead by batch * P at once.
+	int batch = min(m, POLLARD_BSGS_BATCH);
+	epoint *X = new epoint[batch];
+	int *index = new int[batch];
+	epoint ahead(P.get_curve());
+	X[0] = P;
+	for (k = 1; k < batch; k++)
+		X[k] = X[k - 1] + P;
+	for (k = 0; k < batch; k++)
+		index[k] = 0;
+	eccOperations::mul(comb, bint(batch), ahead);
+	for (j = 1; j <= m; j += batch)
+	{
+		for (k = 0; k < batch && j + k <= m; k++)
+			if (!X[k].is_inf())
+				insert(X[k].hash(), j + k);
+		if (j + batch <= m)
+			eccOperations::add_n(X, &ahead, index, batch);
+	}
+	delete [] X;
+	delete [] index;
+}
+
+/* Destructors */
+
+// Frees the table.
+bsgstable::~bsgstable()
+{
+	delete [] tags;
+	delete [] steps;
+}
+
+/* Accessor methods */
+
+// Returns number of baby steps in the table.
+int bsgstable::get_steps(void) const
+{
+	return m;
+}
+
+// Returns order of the group.
+const bint &bsgstable::get_order(void) const
+{
+	return order;
+}
+
+/* Solution methods */
+
+// Solves ECDLP Q = x * P and saves x to result. Returns true if successful (Q belongs to the group generated by P).
+// Saves number of giant steps made to iterations.
+bool bsgstable::solve(const epoint &Q, bint &result, int &iterations) const
+{
+	int k;
+	long long i;
+	long long giants = (long long)(crackRoutines::to_double(order) / (2.0 * m)) + 2;
+	int batch = (int)min((long long)POLLARD_BSGS_BATCH, giants);
+	iterations = 0;
+
+	// Giant steps Q - i * 2m * P: batch of consecutive steps goes back by batch * 2m * P at once.
+	epoint *Y = new epoint[batch];
+	int *index = new int[batch];
+	epoint back(Q.get_curve());
+	Y[0] = Q;
+	for (k = 1; k < batch; k++)
+		Y[k] = Y[k - 1] - stride;
+	for (k = 0; k < batch; k++)
+		index[k] = 0;
+	eccOperations::mul(comb, bint(batch) * bint(2 * m) % order, back);
+	back = -back;
+
+	bool solved = false;
+	for (i = 0; i < giants && !solved; i += batch)
+	{
+		for (k = 0; k < batch && i + k < giants && !solved; k++)
+		{
+			iterations++;
+			solved = match(Y[k], i + k, result);
+		}
+		if (!solved)
+			eccOperations::add_n(Y, &back, index, batch);
+	}
+	delete [] Y;
+	delete [] index;
+	return solved;
+}
+
+/* Internal methods */
+
+// Stores baby step step with x fingerprint hash.
+void bsgstable::insert(unsigned int hash, int step)
+{
+	int i = hash & (capacity - 1);
+	while (steps[i] != 0)
+		i = (i + 1) & (capacity - 1);
+	tags[i] = hash;
+	steps[i] = step;
+}
+
+// Looks up giant step Y = Q - giant * 2m * P in the table. If Y = +-j * P, saves x = giant * 2m +- j to result and returns true.
+bool bsgstable::match(const epoint &Y, long long giant, bint &result) const
+{
+	bint base = crackRoutines::from_double((double)giant) * bint(2 * m);
+	if (Y.is_inf())
+	{
+		result = base % order;
+		return true;
+	}
+	unsigned int hash = Y.hash();
+	epoint C(Y.get_curve());
+	for (int i = hash & (capacity - 1); steps[i] != 0; i = (i + 1) & (capacity - 1))
+	{
+		if (tags[i] != hash)
+			continue;
+		eccOperations::mul(comb, bint(steps[i]), C);
+		if (C == Y)
+			result = (base + bint(steps[i])) % order;
+		else if (C == -Y)
+			result = (base + order - bint(steps[i])) % order;
+		else
+			continue;
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,46 @@
+#ifndef _BSGSTABLE_H
+#define _BSGSTABLE_H
+
+#include "../ecc/epoint.h"
+#include "../ecc/fbpoint.h"
+#include "../ecc/bint.h"
+
+// Baby-step giant-step solver of ECDLP in a group of order order generated by P. Keeps a table of m baby steps j * P (1 <= j <= m),
+// where m = min(sqrt(order / 2), budget). The table is a compact open-addressing hash table: a slot holds a fingerprint of x of j * P
+// (see epoint::hash) and j only, candidates are checked by a multiplication. X and -X share x, so every giant step of 2 * m
+// covers solutions i * 2m - m ... i * 2m + m at once. Steps go in batches sharing one field division.
+// Once built, the table solves any number of points Q (e.g. every digit of Pohlig-Hellman algorithm for the same prime).
+class bsgstable
+{
+public:
+	/* Constructors */
+	bsgstable(const epoint &P, const bint &order, int budget);
+
+	/* Destructors */
+	~bsgstable();
+
+	/* Accessor methods */
+	int get_steps(void) const;
+	const bint &get_order(void) const;
+
+	/* Solution methods */
+	bool solve(const epoint &Q, bint &result, int &iterations) const;
+
+private:
+	bsgstable(const bsgstable &table);
+	void operator= (const bsgstable &table);
+
+	/* Internal methods */
+	void insert(unsigned int hash, int step);
+	bool match(const epoint &Y, long long giant, bint &result) const;
+
+	fbpoint comb;     // comb table of P, checks candidates
+	bint order;
+	int m;            // number of baby steps
+	epoint stride;    // 2 * m * P
+
+	int capacity;     // always a power of two (load factor 1/2)
+	unsigned int *tags;
+	int *steps;       // j of the stored baby step (0 - empty slot)
+};
+#endif
@@ -1,11 +1,24 @@
+// Thread support headers go first: min and max macros of ECC headers break them.
+#include <climits>
+#include <chrono>
+#include <thread>
+#include <atomic>
 #include "crack.h"
 #include "crackdefines.h"
+#include "dpstore.h"
+#include "rhobatch.h"
+#include "iterfunc.h"
+#include "bsgstable.h"
 #include <iostream>
 #include <ctime>
 #include "../ecc/ecurve.h"
 #include "../ecc/eccoperations.h"
 #include "../ecc/bint.h"
 #include "../ecc/bintoperations.h"
+#include "../ecc/cpoint.h"
+#include "../ecc/2nfactory.h"
+#include "../ecc/prng.h"
+#include <cmath>
 
 namespace crackRoutines
 {
@@ -24,28 +37,21 @@ namespace crackRoutines
 		abort();
 	}
 
+	// Returns wall clock time in seconds (unlike clock, it does not sum time of several threads).
+	double wall_clock(void)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
 	// Solves a system of modular equations (from Pollig-Hellman algorithms) and returns it.
 	// Arguments: factors is a pointer to array of pofactor sturctures, n is the length of this array and N is point G order.
+	// Builds a reconstruction plan for a single use - keep a crtplan object, if the same factorization is used many times.
 	bint chinese_remainder_theorem(const pofactor *factors, int n, const bint &N)
 	{
-		int i, r;
 		bint res;
 		if (n == 0) return res;
-		bint *m = new bint[n];
-		bint u, v;
-		for (i = 0; i < n; i++)
-			if ((r = bintOperations::pow(factors[i].p, factors[i].k, m[i])) != bE_OK) bintRoutines::op_err(r);
-		for (i = 0; i < n; i++)
-		{
-			u = N / m[i];
-			//std::cout << "Going to invert: " << u % m[i] << std::endl;
-			//std::cout << "over: " << m[i] << std::endl;
-			if ((r = bintOperations::inv(u % m[i], m[i], v)) != bE_OK) bintRoutines::op_err(r);
-			if (v.is_less_zero()) v += m[i];
-			res = (res + ((factors[i].sol * v) % m[i]) * u) % N;
-		}
-		delete [] m;
-		return res;
+		crtplan plan(factors, n, N);
+		return plan.reconstruct(factors);
 	}
 
 	// Calculates curves point order factorization and returns it.
@@ -83,8 +89,357 @@ namespace crackRoutines
 		}
 		return result;
 	}
+
+	// Adds counts[j] * a[j] and counts[j] * b[j] (j < set_count) to coefficients c and d modulo order and resets counts.
+	void apply_counts(const bint *a, const bint *b, int set_count, const bint &order, int *counts, bint &c, bint &d)
+	{
+		for (int j = 0; j < set_count; j++)
+			if (counts[j] != 0)
+			{
+				c = (c + a[j] * bint(counts[j])) % order;
+				d = (d + b[j] * bint(counts[j])) % order;
+				counts[j] = 0;
+			}
+		// Walks over classes {X, -X} count steps with signs.
+		if (c.is_less_zero()) c += order;
+		if (d.is_less_zero()) d += order;
+	}
+
+	// Advances a walk of iteration function func by length steps.
+	// Walk starts at point X with coefficients c and d (X = c * P + d * Q), which are updated to the final point of the walk.
+	// For additive functions only partition usage is counted while walking, coefficients are updated once at the end.
+	// With negation the walk goes over classes {X, -X} exactly as a fresh walk of rhobatch does.
+	void replay_walk(const iterfunc &func, int length, epoint &X, bint &c, bint &d, bool negation)
+	{
+		int i, j;
+		if (negation)
+		{
+			epoint T(X.get_curve());
+			rhobatch walk(func, 1, true);
+			walk.set_seed(X, c, d, T, bint(0), bint(0));
+			walk.restart(0);
+			for (i = 0; i < length; i++)
+				walk.step();
+			X = walk.get_point(0);
+			walk.get_coefficients(0, c, d);
+			return;
+		}
+		bool additive = func.is_additive();
+		int *counts = new int[func.get_set_count()];
+		for (j = 0; j < func.get_set_count(); j++)
+			counts[j] = 0;
+		for (i = 0; i < length; i++)
+		{
+			j = func.step(X);
+			if (additive)
+				counts[j]++;
+			else
+				func.apply(j, c, d);
+		}
+		if (additive)
+			func.apply_counts(counts, c, d);
+		delete [] counts;
+	}
+
+	// Generates random r-adding iteration function: R[j] = a[j] * P + b[j] * Q (j < set_count), where combs hold P and Q.
+	// Every a * P + b * Q is computed jointly, sharing comb doublings.
+	void generate_iteration_function(const fbpoint *combs, const bint &order, int set_count, epoint *R, bint *a, bint *b)
+	{
+		bint scalars[2];
+		for (int i = 0; i < set_count; i++)
+		{
+			a[i].random_mod(order);
+			b[i].random_mod(order);
+			scalars[0] = a[i]; scalars[1] = b[i];
+			eccOperations::mul(combs, scalars, 2, R[i]);
+		}
+	}
+
+	// Generates jumps of kangaroo method: R[j] = a[j] * P, b[j] = 0 (j < set_count), where comb holds P.
+	// Jump sizes are spread evenly over (0, 2 * mean], so their mean is about mean: every jump is random within its slice
+	// (evenly spaced sizes would share a common divisor, then kangaroos starting a non-multiple apart never meet).
+	void generate_kangaroo_jumps(const fbpoint &comb, const bint &order, double mean, int set_count, epoint *R, bint *a, bint *b)
+	{
+		bint slice = from_double(max(1.0, 2 * mean / set_count));
+		for (int i = 0; i < set_count; i++)
+		{
+			a[i].random_mod(slice);
+			a[i] = (a[i] + bint(1) + from_double(2 * mean * i / set_count)) % order;
+			b[i].zero();
+			eccOperations::mul(comb, a[i], R[i]);
+		}
+	}
+
+	// Returns non-negative big integer n as a double.
+	double to_double(const bint &n)
+	{
+		int i, count;
+		unsigned int words[bWordCount];
+		bintOperations::to_words(n, words, count);
+		double res = 0;
+		for (i = count - 1; i >= 0; i--)
+			res = res * (1 << bWordBits) + words[i];
+		return res;
+	}
+
+	// Returns integer part of non-negative n as a big integer.
+	bint from_double(double n)
+	{
+		const double base = 1 << 30;
+		int digits[40], count = 0;
+		n = floor(n);
+		while (n >= 1 && count < 40)
+		{
+			digits[count++] = (int)fmod(n, base);
+			n = floor(n / base);
+		}
+		bint res(0);
+		while (count > 0)
+			res = res * bint(1 << 30) + bint(digits[--count]);
+		return res;
+	}
+
+	// Returns expected number of rho-method steps until a collision in a group of order order: sqrt(pi * order / 2).
+	double expected_steps(const bint &order)
+	{
+		return sqrt(3.14159265358979 * to_double(order) / 2);
+	}
+
+	// Returns expected number of kangaroo method steps for an interval of width width: 2 * sqrt(width).
+	double kangaroo_steps(const bint &width)
+	{
+		return 2 * sqrt(to_double(width));
+	}
+
+	// Returns expected number of baby-step giant-step method steps in a group of order order with at most budget baby steps
+	// (see bsgstable): m baby steps and half of order / (2 * m) giant steps on average.
+	double bsgs_steps(const bint &order, int budget)
+	{
+		double n = to_double(order);
+		double m = max(1.0, min((double)budget, ceil(sqrt(n / 2))));
+		return m + n / (4 * m);
+	}
+
+	// Returns expected number of rho-method steps of Pohlig-Hellman algorithm over n prime-power factors (see expected_steps),
+	// negation sets walks over classes {P, -P}.
+	double pohlig_hellman_steps(const pofactor *factors, int n, bool negation)
+	{
+		double steps = 0;
+		for (int i = 0; i < n; i++)
+			steps += factors[i].k * expected_steps(factors[i].p);
+		return negation ? steps / sqrt(2.0) : steps;
+	}
+
+	// Returns number of distinguished point criterion bits for walks walks, that are expected to make steps steps together.
+	// Every walk is expected to pass about POLLARD_DP_SPACING distinguished points. Non-negative dp_bits overrides the choice.
+	int distinguished_bits(double steps, int walks, int dp_bits)
+	{
+		int bits = 0;
+		if (dp_bits >= 0) return min(dp_bits, POLLARD_DP_MAX_BITS);
+		while (bits < POLLARD_DP_MAX_BITS && (double)(2 << bits) * POLLARD_DP_SPACING * walks <= steps)
+			bits++;
+		return bits;
+	}
+
+	// Solves c1 + d1 * x = c2 + d2 * x (mod order) for x and saves it to result.
+	// Returns false, if the collision is useless (d1 = d2).
+	bool solve_collision(bint c1, bint d1, bint c2, bint d2, const bint &order, bint &result)
+	{
+		c1 -= c2; if (c1.is_less_zero()) c1 += order;
+		d2 -= d1; if (d2.is_less_zero()) d2 += order;
+		if (d2.is_zero()) return false;
+		bintOperations::inv(d2, order, d1);
+		if (d1.is_less_zero()) d1 += order;
+		result = (c1 * d1) % order;
+		return true;
+	}
+
+	// Finds eigenvalue lambda of Frobenius map on the group of prime order order generated by P: tau(P) = lambda * P.
+	// Curve must be a Koblitz curve: tau^m - 1 = a0 + a1 * tau maps every its point to infinity, so lambda = -a0 / a1 or the other root
+	// of lambda^2 - mu * lambda + 2, both are checked. Returns size of Frobenius orbits in the group (0 if lambda is not found).
+	int frobenius_eigenvalue(const epoint &P, const bint &order, bint &lambda)
+	{
+		int i;
+		const ecurve &curve = P.get_curve();
+		if (!curve.is_koblitz() || P.is_inf()) return 0;
+		int m = curve.get_field().get_deg();
+		int mu = curve.get_a().is_zero() ? -1 : 1;
+
+		bint A, B, t;
+		eccOperations::tau_power(mu, m, A, B);
+		A = A % order;
+		B = B % order;
+		if (B.is_less_zero()) B += order;
+		if (B.is_zero()) return 0;
+		bintOperations::inv(B, order, t);
+		lambda = ((bint(1) - A) * t) % order;
+		if (lambda.is_less_zero()) lambda += order;
+
+		epoint image(curve), check(curve);
+		eccOperations::frobenius(P, image);
+		for (i = 0; i < 2; i++)
+		{
+			eccOperations::mul(P, lambda, check);
+			if (check == image) break;
+			lambda = (bint(mu) - lambda) % order;
+			if (lambda.is_less_zero()) lambda += order;
+		}
+		if (i == 2) return 0;
+
+		t = lambda;
+		for (i = 1; i < m && !t.is_one(); i++)
+			t = (t * lambda) % order;
+		return i;
+	}
 }
 
+/* crtplan class */
+
+/* Constructors */
+
+// Creates a reconstruction plan for moduli factors[i].p ^ factors[i].k (i < n), which multiply to N.
+crtplan::crtplan(const pofactor *factors, int n, const bint &N) : n(n), N(N)
+{
+	int i, r;
+	m = new bint[n];
+	prefix = new bint[n];
+	inverse = new bint[n];
+	for (i = 0; i < n; i++)
+	{
+		if ((r = bintOperations::pow(factors[i].p, factors[i].k, m[i])) != bE_OK) bintRoutines::op_err(r);
+		if (i == 0)
+		{
+			prefix[i].one();
+			inverse[i].one();
+			continue;
+		}
+		prefix[i] = prefix[i - 1] * m[i - 1];
+		if ((r = bintOperations::inv(prefix[i] % m[i], m[i], inverse[i])) != bE_OK) bintRoutines::op_err(r);
+		if (inverse[i].is_less_zero()) inverse[i] += m[i];
+	}
+}
+
+/* Destructors */
+
+// Frees precomputed data.
+crtplan::~crtplan()
+{
+	delete [] m;
+	delete [] prefix;
+	delete [] inverse;
+}
+
+/* Accessor methods */
+
+// Returns number of moduli.
+int crtplan::get_count(void) const
+{
+	return n;
+}
+
+// Returns i-th modulus.
+const bint &crtplan::get_modulus(int i) const
+{
+	return m[i];
+}
+
+/* Reconstruction methods */
+
+// Returns x modulo N, such that x = residues[i] (mod m[i]) for every i.
+// Garner's algorithm: x = v[0] + v[1] * prefix[1] + ... + v[n - 1] * prefix[n - 1], where v[i] = (residues[i] - x) * inverse[i] (mod m[i]).
+bint crtplan::reconstruct(const bint *residues) const
+{
+	int i;
+	bint x, v;
+	for (i = 0; i < n; i++)
+	{
+		v = (residues[i] - x % m[i]) % m[i];
+		if (v.is_less_zero()) v += m[i];
+		if (i > 0)
+		{
+			v = (v * inverse[i]) % m[i];
+			v = v * prefix[i];
+		}
+		x += v;
+	}
+	if (x >= N) x = x % N;
+	return x;
+}
+
+// Returns x modulo N, such that x = factors[i].sol (mod m[i]) for every i.
+bint crtplan::reconstruct(const pofactor *factors) const
+{
+	bint *residues = new bint[n];
+	for (int i = 0; i < n; i++)
+		residues[i] = factors[i].sol;
+	bint result = reconstruct(residues);
+	delete [] residues;
+	return result;
+}
+
+// Reconstructs count residue vectors at once. Vector j is stored in residues[j * n], ..., residues[j * n + n - 1] and its result is saved to results[j].
+void crtplan::reconstruct(const bint *residues, int count, bint *results) const
+{
+	for (int j = 0; j < count; j++)
+		results[j] = reconstruct(residues + j * n);
+}
+
+// State of batched rho-method shared by its threads.
+struct rhosearch
+{
+	// Read-only search parameters
+	const ecurve *curve;
+	const fbpoint *combs; // comb tables of P and Q
+	const iterfunc *func;
+	const bint *order;
+	int walks;            // walks per thread
+	bool negation;        // walks over classes {P, -P}
+	const bint *lambda;   // Frobenius eigenvalue, when walks go over classes {+-tau^i(P)} (null otherwise)
+	int mask;             // distinguished point criterion
+	int maxLength;
+	double maxIterations;
+	prng generator;       // split into one stream per thread
+	const bint *middle;   // kangaroo method: start of tame herds (middle of the interval)
+	bint spread;          // kangaroo method: herds start within this distance from their origin (mean jump)
+
+	// Shared state: result is written by the thread, that sets solved first
+	dpstore *store;
+	std::atomic<bool> stop;
+	std::atomic<long long> iterations;
+	std::atomic<bool> solved;
+	bint result;
+};
+
+// State of Pohlig-Hellman algorithm for a prime-power subgroup of order p ^ k, shared by its subproblems.
+struct phsearch
+{
+	const bint *p;
+	int k;
+	epoint *powers;          // powers[s] = p ^ s * G', where G' generates the subgroup (powers[k - 1] is of order p)
+	bint *ppowers;           // ppowers[s] = p ^ s (s <= k)
+	const bsgstable *table;  // baby steps of powers[k - 1], shared by all digits (null - digits are solved by rho-method)
+	int digit;               // number of digits solved so far
+	bool verbose;
+	char *offset;
+	char *time_string;
+};
+
+/* crack class */
+
+/* Static variables */
+
+int crack::solve_mode = POLLARD_SOLVE_MODE;
+int crack::walk_mode = POLLARD_WALK_MODE;
+int crack::search_mode = POLLARD_SEARCH_MODE;
+int crack::dp_bits = POLLARD_DP_BITS;
+int crack::thread_count = POLLARD_THREADS;
+bool crack::negation_map = POLLARD_NEGATION_MAP != 0;
+bool crack::frobenius_map = POLLARD_FROBENIUS_MAP != 0;
+int crack::set_count = POLLARD_SET_COUNT;
+int crack::doubling_count = POLLARD_DOUBLING_COUNT;
+int crack::partition = POLLARD_PARTITION;
+int crack::bsgs_budget = POLLARD_BSGS_BUDGET;
+
 /* Constructors */
 
 // Creates a new instance of crack class, that will crack a cipher over a given elliptic curve.
@@ -93,18 +448,31 @@ crack::crack(const ecurve &curve)
 {
 	this->curve = &curve;
 	running = false;
+	plan = 0;
+	bounded = false;
 }
 
 // Creates a new instance of crack class, that will crack a cipher over a given elliptic curve.
 // Takes crack data as arguments.
-crack::crack(const ecurve &curve, const epoint &G, const epoint &xG) : G(G), xG(xG)
+crack::crack(const ecurve &curve, const epoint &G, const epoint &xG) : G(G), xG(xG), Gcomb(G)
 {
 	this->curve = &curve;
 	running = false;
+	plan = 0;
+	bounded = false;
 	if (!curve.belongs_to_curve(G) || !curve.belongs_to_curve(xG))
 		crackRoutines::op_err(ckE_DIFFCURVES);
 }
 
+/* Destructors */
+
+// Frees reconstruction plan.
+crack::~crack()
+{
+	if (plan != 0)
+		delete plan;
+}
+
 /* Setter methods */
 
 // Sets elliptic curve point G from ECDLP problem.
@@ -114,6 +482,12 @@ void crack::set_G(const epoint &G)
 		crackRoutines::op_err(ckE_RUNNING);
 	if (!curve->belongs_to_curve(G)) crackRoutines::op_err(ckE_DIFFCURVES);
 	this->G = G;
+	Gcomb.assign(G);
+	if (plan != 0)
+	{
+		delete plan;
+		plan = 0;
+	}
 }
 
 // Sets elliptic curve point xG from ECDLP problem.
@@ -125,6 +499,25 @@ void crack::set_xG(const epoint &xG)
 	this->xG = xG;
 }
 
+// Sets interval [lo, hi], that is known to hold the solution (e.g. helpers::choose_key picks keys from the upper half of the group).
+// Then solve may use kangaroo method (see set_solve_mode).
+void crack::set_interval(const bint &lo, const bint &hi)
+{
+	if (running)
+		crackRoutines::op_err(ckE_RUNNING);
+	this->lo = lo;
+	this->hi = hi;
+	bounded = true;
+}
+
+// Forgets interval of the solution.
+void crack::clear_interval(void)
+{
+	if (running)
+		crackRoutines::op_err(ckE_RUNNING);
+	bounded = false;
+}
+
 /* Accessor methods */
 
 // Returns elliptic curve point G from Pollig-Hellman key exchange algorithms.
@@ -139,6 +532,15 @@ const epoint &crack::get_xG(void)
 	return xG;
 }
 
+// Saves interval of the solution to lo and hi. Returns false if it is not set.
+bool crack::get_interval(bint &lo, bint &hi)
+{
+	if (!bounded) return false;
+	lo = this->lo;
+	hi = this->hi;
+	return true;
+}
+
 /* Helper methods */
 
 // Returns true if ECDLP solver is already working, otherwise - false.
@@ -147,65 +549,270 @@ bool crack::is_running(void)
 	return running;
 }
 
+/* Configuration methods */
+
+// Sets method used by solve (one of POLLARD_SOLVE_* constants).
+void crack::set_solve_mode(int mode)
+{
+	switch (mode)
+	{
+	case POLLARD_SOLVE_AUTO :
+	case POLLARD_SOLVE_POHLIG_HELLMAN :
+	case POLLARD_SOLVE_KANGAROO :
+		solve_mode = mode;
+		break;
+	default :
+		break;
+	}
+}
+
+// Returns method used by solve.
+int crack::get_solve_mode(void)
+{
+	return solve_mode;
+}
+
+// Sets walk mode used by Pollards rho-method (one of POLLARD_WALK_* constants).
+void crack::set_walk_mode(int mode)
+{
+	switch (mode)
+	{
+	case POLLARD_WALK_TRACKED :
+	case POLLARD_WALK_REPLAY :
+		walk_mode = mode;
+		break;
+	default :
+		break;
+	}
+}
+
+// Returns walk mode used by Pollards rho-method.
+int crack::get_walk_mode(void)
+{
+	return walk_mode;
+}
+
+// Sets collision search used by Pollards rho-method (one of POLLARD_SEARCH_* constants).
+void crack::set_search_mode(int mode)
+{
+	switch (mode)
+	{
+	case POLLARD_SEARCH_FLOYD :
+	case POLLARD_SEARCH_BATCH :
+	case POLLARD_SEARCH_DP :
+	case POLLARD_SEARCH_BRENT :
+		search_mode = mode;
+		break;
+	default :
+		break;
+	}
+}
+
+// Returns collision search used by Pollards rho-method.
+int crack::get_search_mode(void)
+{
+	return search_mode;
+}
+
+// Sets number of distinguished point criterion bits (negative value lets the criterion follow expected number of steps).
+void crack::set_dp_bits(int bits)
+{
+	dp_bits = bits;
+}
+
+// Returns number of distinguished point criterion bits (negative, when it follows expected number of steps).
+int crack::get_dp_bits(void)
+{
+	return dp_bits;
+}
+
+// Sets number of threads running batched rho-method (0 - one per hardware thread). Negative values are ignored.
+void crack::set_thread_count(int count)
+{
+	if (count >= 0)
+		thread_count = count;
+}
+
+// Returns number of threads running batched rho-method (0 - one per hardware thread).
+int crack::get_thread_count(void)
+{
+	return thread_count;
+}
+
+// Sets whether batched rho-method walks over classes {P, -P} (see rhobatch).
+void crack::set_negation_map(bool enabled)
+{
+	negation_map = enabled;
+}
+
+// Returns true if batched rho-method walks over classes {P, -P}.
+bool crack::get_negation_map(void)
+{
+	return negation_map;
+}
+
+// Sets whether batched rho-method on Koblitz curves extends classes to {+-tau^i(P)} (together with negation map).
+void crack::set_frobenius_map(bool enabled)
+{
+	frobenius_map = enabled;
+}
+
+// Returns true if batched rho-method on Koblitz curves extends classes to {+-tau^i(P)}.
+bool crack::get_frobenius_map(void)
+{
+	return frobenius_map;
+}
+
+// Sets number of sets of iteration function used by Pollards rho-method (see iterfunc). Values less than 2 are ignored.
+void crack::set_set_count(int count)
+{
+	if (count >= 2)
+	{
+		set_count = count;
+		doubling_count = min(doubling_count, count - 1);
+	}
+}
+
+// Returns number of sets of iteration function used by Pollards rho-method.
+int crack::get_set_count(void)
+{
+	return set_count;
+}
+
+// Sets number of iteration function sets, that double points (Teske's mixed walk). At least one set must add points, other values are ignored.
+void crack::set_doubling_count(int count)
+{
+	if (count >= 0 && count < set_count)
+		doubling_count = count;
+}
+
+// Returns number of iteration function sets, that double points.
+int crack::get_doubling_count(void)
+{
+	return doubling_count;
+}
+
+// Sets partition choosing sets of iteration function (one of POLLARD_PARTITION_* constants).
+void crack::set_partition(int partition)
+{
+	switch (partition)
+	{
+	case POLLARD_PARTITION_BITS :
+	case POLLARD_PARTITION_HASH :
+		crack::partition = partition;
+		break;
+	default :
+		break;
+	}
+}
+
+// Returns partition choosing sets of iteration function.
+int crack::get_partition(void)
+{
+	return partition;
+}
+
+// Sets maximum number of baby steps stored by baby-step giant-step method (see bsgstable). Non-positive values are ignored.
+// Smaller budget takes more giant steps, so rho-method takes over in smaller groups.
+void crack::set_bsgs_budget(int budget)
+{
+	if (budget > 0)
+		bsgs_budget = min(budget, INT_MAX / 4);
+}
+
+// Returns maximum number of baby steps stored by baby-step giant-step method.
+int crack::get_bsgs_budget(void)
+{
+	return bsgs_budget;
+}
+
 /* Control methods */
 
 bool crack::solve(bint &result, bool verbose, char *offset, double &work_time)
 {
-	work_time = clock();
+	work_time = crackRoutines::wall_clock();
 	if (running) crackRoutines::op_err(ckE_RUNNING);
 	int i, j;
-	int factor_count;
+	int factor_count = 0;
 	pofactor *factors = crackRoutines::calculate_point_order_factorization(G, factor_count);
-	char *time_string = new char[LINE_LEN];
 	bint order;
 	G.order(order);
-	for (i = 0; i < factor_count; i++)
+
+	// Kangaroo method goes first, if the solution is known to lie in a short enough interval.
+	if (bounded && solve_mode != POLLARD_SOLVE_POHLIG_HELLMAN)
 	{
-		if (verbose) std::cout << offset << "[i] Solving for prime-power subgroup (" << factors[i].p << " ^ " << factors[i].k << ")" << std::endl;
-		factors[i].sol.zero();
-		epoint temp = xG;
-		bint power(1);
-		bint temp_solution;
-		bint N = order /  factors[i].p;
-		epoint P(*curve), Q(*curve);
-		eccOperations::mul(G, N, P);
-		for (j = 0; j < factors[i].k; j++)
+		if (solve_mode == POLLARD_SOLVE_KANGAROO || factors == 0 ||
+			crackRoutines::kangaroo_steps(hi - lo + bint(1)) < crackRoutines::pohlig_hellman_steps(factors, factor_count, negation_map))
 		{
-			eccOperations::mul(temp, N, Q);
-			int attempt = 0;
-			bool solved = false;
-			if (verbose) std::cout << offset << "    [i] Solving for (" << factors[i].p << " ^ " << j + 1 << ")" << std::endl;
-			while (!solved && attempt < MAX_POLLARD_ATTEMPTS)
+			bool solved = solve_kangaroo(order, result, verbose, offset);
+			if (solved || solve_mode == POLLARD_SOLVE_KANGAROO || factors == 0)
 			{
-				int iterations = -1;
-				double work_time = 10;
-				solved = pollard(P, Q, factors[i].p, temp_solution, iterations, work_time);
-				if (verbose) sprintf(time_string, PRINT_FORMAT, work_time);
-				if (!solved)
-				{
-					if (verbose) std::cout << offset << "        [-] (" << attempt + 1 << ") Fail: " << iterations << " iterations (" << time_string << " seconds)" << std::endl;
-				}
-				else
-					if (verbose) std::cout << offset << "        [+] (" << attempt + 1 << ") Success: " << iterations << " iterations (" << time_string << " seconds)" << std::endl;
-				attempt++;
+				if (factors != 0)
+					delete[] factors;
+				work_time = crackRoutines::wall_clock() - work_time;
+				return solved;
 			}
-			if (!solved)
+		}
+	}
+
+	char *time_string = new char[LINE_LEN];
+	phsearch search;
+	search.verbose = verbose;
+	search.offset = offset;
+	search.time_string = time_string;
+	bool solved = true;
+	for (i = 0; i < factor_count && solved; i++)
+	{
+		if (verbose) std::cout << offset << "[i] Solving for prime-power subgroup (" << factors[i].p << " ^ " << factors[i].k << ")" << std::endl;
+		int k = factors[i].k;
+		search.p = &factors[i].p;
+		search.k = k;
+		search.digit = 0;
+		search.ppowers = new bint[k + 1];
+		search.ppowers[0] = bint(1);
+		for (j = 1; j <= k; j++)
+			search.ppowers[j] = search.ppowers[j - 1] * factors[i].p;
+
+		// Subgroup of order p ^ k is generated by G' = (order / p ^ k) * G, xG goes to H = (order / p ^ k) * xG.
+		bint N = order / search.ppowers[k];
+		epoint H(*curve);
+		search.powers = new epoint[k];
+		eccOperations::mul(Gcomb, N, search.powers[0]);
+		for (j = 1; j < k; j++)
+			eccOperations::mul(search.powers[j - 1], factors[i].p, search.powers[j]);
+		eccOperations::mul(xG, N, H);
+
+		// Every digit is solved in the same group of order p, so one baby-step table serves all of them.
+		search.table = 0;
+		if (use_bsgs(factors[i].p))
+		{
+			double table_time = crackRoutines::wall_clock();
+			search.table = new bsgstable(search.powers[k - 1], factors[i].p, bsgs_budget);
+			if (verbose)
 			{
-				delete[] time_string;
-				return false;
+				sprintf(time_string, PRINT_FORMAT, crackRoutines::wall_clock() - table_time);
+				std::cout << offset << "    [i] Baby steps table: " << search.table->get_steps() << " steps (" << time_string << " seconds)" << std::endl;
 			}
-			bint temp_number = temp_solution * power;
-			factors[i].sol += temp_number;
-			eccOperations::mul(G, temp_number, Q);
-			temp -= Q;
-			power = power * factors[i].p;
-			N = N / factors[i].p;
 		}
+		solved = solve_prime_power(&search, 0, k, H, factors[i].sol);
+		delete search.table;
+		delete[] search.powers;
+		delete[] search.ppowers;
+	}
+	if (!solved)
+	{
+		delete[] factors;
+		delete[] time_string;
+		return false;
 	}
 
-	result = crackRoutines::chinese_remainder_theorem(factors, factor_count, order);
-	work_time = (clock() - work_time) / (double)CLOCKS_PER_SEC;
+	// Reconstruction plan depends only on G, so it is reused while solving for other xG.
+	if (plan == 0)
+		plan = new crtplan(factors, factor_count, order);
+	result = plan->reconstruct(factors);
+	work_time = crackRoutines::wall_clock() - work_time;
 
+	delete[] factors;
 	delete[] time_string;
 	return true;
 }
@@ -237,63 +844,596 @@ bool crack::bruteforce(const epoint &P, const epoint &Q, const bint &order, bint
 	return false;
 }
 
+// Baby-step giant-step ECDLP solver (deterministic, see bsgstable), stores at most bsgs budget baby steps.
+bool crack::bsgs(const epoint &P, const epoint &Q, const bint &order, bint &result, int &iterations, double &work_time)
+{
+	iterations = 0;
+	const ecurve &curve = P.get_curve();
+	if (!curve.belongs_to_curve(Q)) return false;
+	work_time = crackRoutines::wall_clock();
+	bsgstable table(P, order, bsgs_budget);
+	bool solved = table.solve(Q, result, iterations);
+	iterations += table.get_steps();
+	work_time = crackRoutines::wall_clock() - work_time;
+	return solved;
+}
+
 // Pollards rho-method ECDLP solver.
+// Collision search is chosen by search mode (see set_search_mode). Small groups are solved by baby-step giant-step method,
+// when it is expected to take no more steps (see POLLARD_BSGS_MAX_ORDER).
 bool crack::pollard(const epoint &P, const epoint &Q, const bint &order, bint &result, int &iterations, double &work_time)
 {
-	int i, j;
 	iterations = 0;
 	const ecurve &curve = P.get_curve();
 	if (!curve.belongs_to_curve(Q)) return false;
-	if (order < POLLARD_MIN_ORDER) return bruteforce(P, Q, order, result, iterations, work_time);
+	if (use_bsgs(order))
+		return bsgs(P, Q, order, result, iterations, work_time);
 
-	epoint tempPoint(curve), X1(curve), X2(curve);
-	bint c1, d1, c2, d2;
-	bint *a = new bint[POLLARD_SET_COUNT];
-	bint *b = new bint[POLLARD_SET_COUNT];
-	epoint *R = new epoint[POLLARD_SET_COUNT];
+	switch (search_mode)
+	{
+	case POLLARD_SEARCH_BATCH :
+		return pollard_batch(P, Q, order, result, iterations, work_time);
+	case POLLARD_SEARCH_DP :
+		return pollard_dp(P, Q, order, result, iterations, work_time);
+	case POLLARD_SEARCH_BRENT :
+		return pollard_brent(P, Q, order, result, iterations, work_time);
+	default :
+		return pollard_floyd(P, Q, order, result, iterations, work_time);
+	}
+}
 
-	for (i = 0; i < POLLARD_SET_COUNT; i++)
+// Pollards kangaroo (lambda) method ECDLP solver for a solution known to lie in the interval [lo, hi] (parallel version
+// of van Oorschot and Wiener). Tame kangaroos start at the middle of the interval, wild ones at Q, all of them jump forward
+// by multiples of P. Mean jump is chosen so herds meet in about 2 * sqrt(hi - lo + 1) steps in total, a tame and a wild
+// kangaroo landing on the same distinguished point give the solution. Every thread advances a tame and a wild herd.
+bool crack::kangaroo(const epoint &P, const epoint &Q, const bint &order, const bint &lo, const bint &hi, bint &result, int &iterations, double &work_time)
+{
+	iterations = 0;
+	work_time = 0;
+	const ecurve &curve = P.get_curve();
+	if (!curve.belongs_to_curve(Q) || hi < lo) return false;
+	bint width = hi - lo + bint(1);
+	if (width < POLLARD_MIN_ORDER)
 	{
-		a[i].random(); a[i] = a[i] % order;
-		b[i].random(); b[i] = b[i] % order;
-		eccOperations::mul(P, a[i], R[i]);
-		eccOperations::mul(Q, b[i], tempPoint);
-		R[i] += tempPoint;
+		epoint R(curve);
+		eccOperations::mul(P, lo, R);
+		R = Q - R;
+		if (!bruteforce(P, R, width, result, iterations, work_time)) return false;
+		result = (result + lo) % order;
+		return true;
 	}
 
-	c1.random(); c1 = c1 % order;
-	d1.random(); d1 = d1 % order;
-	eccOperations::mul(P, c1, X1);
-	eccOperations::mul(Q, d1, tempPoint);
-	X1 += tempPoint;
+	fbpoint combs[2];
+	combs[0].assign(P);
+	combs[1].assign(Q);
+
+	double steps = crackRoutines::kangaroo_steps(width);
+	int threads = thread_count > 0 ? thread_count : (int)std::thread::hardware_concurrency();
+	threads = (int)min((double)max(threads, 1), max(1.0, steps / POLLARD_THREAD_STEPS));
+	int walks = (int)min((double)POLLARD_BATCH_WALKS / 2, max(1.0, steps / threads / 2 / POLLARD_BATCH_WALK_STEPS));
+	int kangaroos = 2 * walks * threads;
+	int bits = crackRoutines::distinguished_bits(steps, kangaroos, dp_bits);
+	double mean = max(1.0, kangaroos * sqrt(crackRoutines::to_double(width)) / 4);
+
+	epoint *R = new epoint[set_count];
+	bint *a = new bint[set_count];
+	bint *b = new bint[set_count];
+	crackRoutines::generate_kangaroo_jumps(combs[0], order, mean, set_count, R, a, b);
+	iterfunc func(R, a, b, order, set_count, 0, partition);
+	delete [] R;
+	delete [] a;
+	delete [] b;
+
+	bint middle = (lo + width / bint(2)) % order;
+	dpstore store((int)min(steps * 2 / (1 << bits), (double)POLLARD_DP_CAPACITY * POLLARD_DP_PRESIZE) + POLLARD_DP_CAPACITY);
+	prng &generator = prng::global();
+	rhosearch search;
+	search.curve = &curve;
+	search.combs = combs;
+	search.func = &func;
+	search.order = &order;
+	search.walks = walks;
+	search.negation = false;
+	search.lambda = 0;
+	search.mask = ((1 << bits) - 1) << POLLARD_DP_SHIFT;
+	// Kangaroos only jump forward, so they are never trapped in a cycle.
+	search.maxLength = INT_MAX;
+	search.maxIterations = POLLARD_MAX_EXPECTED * steps + (double)kangaroos * (POLLARD_DP_MAX_LENGTH << bits);
+	search.generator = generator.split(((unsigned long long)generator.next() << 32) | generator.next());
+	search.middle = &middle;
+	search.spread = crackRoutines::from_double(mean);
+	search.store = &store;
+	search.stop = false;
+	search.iterations = 0;
+	search.solved = false;
+
+	work_time = crackRoutines::wall_clock();
+	run_threads(&search, threads, kangaroo_thread);
+	work_time = crackRoutines::wall_clock() - work_time;
+
+	iterations = (int)min((long long)INT_MAX, search.iterations.load());
+	if (search.solved) result = search.result;
+
+	return search.solved;
+}
+
+/* Solution methods */
+
+// Solves ECDLP by kangaroo method over the interval of the solution and saves it to result. Returns true if successful.
+bool crack::solve_kangaroo(const bint &order, bint &result, bool verbose, char *offset)
+{
+	int iterations = -1;
+	double work_time = 0;
+	if (verbose) std::cout << offset << "[i] Solving in interval [" << lo << ", " << hi << "] by kangaroo method" << std::endl;
+	bool solved = kangaroo(G, xG, order, lo, hi, result, iterations, work_time);
+	if (verbose)
+	{
+		char *time_string = new char[LINE_LEN];
+		sprintf(time_string, PRINT_FORMAT, work_time);
+		if (solved)
+			std::cout << offset << "    [+] Success: " << iterations << " iterations (" << time_string << " seconds)" << std::endl;
+		else
+			std::cout << offset << "    [-] Fail: " << iterations << " iterations (" << time_string << " seconds)" << std::endl;
+		delete[] time_string;
+	}
+	return solved;
+}
+
+// Solves h = x * powers[shift] for x modulo p ^ e (powers[shift] is of order p ^ e) and saves x to result by Shoup's
+// divide-and-conquer: x = x1 + p ^ e1 * x2, where x1 is found from p ^ e2 * h in the subgroup of order p ^ e1 and x2 from
+// h - x1 * powers[shift] in the subgroup of order p ^ e2. Splitting in halves takes O(k log k) multiplications for the whole
+// p ^ k subgroup instead of O(k ^ 2) of digit by digit solution. Digits are solved from the lowest one.
+bool crack::solve_prime_power(phsearch *search, int shift, int e, const epoint &h, bint &result)
+{
+	if (e == 1)
+		return solve_digit(search, h, result);
+	int e1 = e / 2, e2 = e - e1;
+	bint x1, x2;
+	epoint R(h.get_curve()), S(h.get_curve());
+	eccOperations::mul(h, search->ppowers[e2], R);
+	if (!solve_prime_power(search, shift + e2, e1, R, x1))
+		return false;
+	eccOperations::mul(search->powers[shift], x1, S);
+	R = h;
+	R -= S;
+	if (!solve_prime_power(search, shift + e1, e2, R, x2))
+		return false;
+	result = x1 + search->ppowers[e1] * x2;
+	return true;
+}
+
+// Solves the next digit of Pohlig-Hellman algorithm: h = d * powers[k - 1] in the group of order p, saves d to result.
+// Uses the shared baby-step table if there is one (a single deterministic attempt), rho-method otherwise.
+bool crack::solve_digit(phsearch *search, const epoint &h, bint &result)
+{
+	search->digit++;
+	if (search->verbose) std::cout << search->offset << "    [i] Solving for (" << *search->p << " ^ " << search->digit << ")" << std::endl;
+	int attempts = search->table != 0 ? 1 : MAX_POLLARD_ATTEMPTS;
+	int attempt = 0;
+	bool solved = false;
+	while (!solved && attempt < attempts)
+	{
+		int iterations = -1;
+		double work_time = 10;
+		if (search->table != 0)
+		{
+			work_time = crackRoutines::wall_clock();
+			solved = search->table->solve(h, result, iterations);
+			work_time = crackRoutines::wall_clock() - work_time;
+		}
+		else
+			solved = pollard(search->powers[search->k - 1], h, *search->p, result, iterations, work_time);
+		if (search->verbose)
+		{
+			sprintf(search->time_string, PRINT_FORMAT, work_time);
+			if (!solved)
+				std::cout << search->offset << "        [-] (" << attempt + 1 << ") Fail: " << iterations << " iterations (" << search->time_string << " seconds)" << std::endl;
+			else
+				std::cout << search->offset << "        [+] (" << attempt + 1 << ") Success: " << iterations << " iterations (" << search->time_string << " seconds)" << std::endl;
+		}
+		attempt++;
+	}
+	return solved;
+}
+
+/* Collision search methods */
+
+// Pollards rho-method with a single walk and Floyd's cycle finding.
+bool crack::pollard_floyd(const epoint &P, const epoint &Q, const bint &order, bint &result, int &iterations, double &work_time)
+{
+	int i, j;
+	const ecurve &curve = P.get_curve();
+	epoint X1(curve), X2(curve);
+	bint c1, d1, c2, d2;
+
+	// P and Q are multiplied by set_count + 1 random scalars each, so comb tables pay off.
+	fbpoint combs[2];
+	bint scalars[2];
+	combs[0].assign(P);
+	combs[1].assign(Q);
+	iterfunc func(combs, order, set_count, doubling_count, partition);
+
+	c1.random_mod(order);
+	d1.random_mod(order);
+	scalars[0] = c1; scalars[1] = d1;
+	eccOperations::mul(combs, scalars, 2, X1);
 	c2 = c1; d2 = d1; X2 = X1;
 	work_time = clock();
-	do
+	if (walk_mode == POLLARD_WALK_REPLAY)
 	{
-		j = X1.f(POLLARD_SET_ARG);
-		X1 += R[j];
-		c1 += a[j]; if (c1 >= order) c1 -= order;
-		d1 += b[j]; if (d1 >= order) d1 -= order;
-		for (i = 0; i < 2; i++)
+		// Walk points only, the seed (c1, d1, X1) is kept for replay
+		epoint X0 = X1;
+		do
+		{
+			func.step(X1);
+			for (i = 0; i < 2; i++)
+				func.step(X2);
+			iterations++;
+		} while (X1 != X2);
+
+		// Replay the walk from its seed to recover coefficients of both colliding points
+		X1 = X0;
+		crackRoutines::replay_walk(func, iterations, X1, c1, d1, false);
+		X2 = X1; c2 = c1; d2 = d1;
+		crackRoutines::replay_walk(func, iterations, X2, c2, d2, false);
+	}
+	else
+	{
+		do
+		{
+			j = func.step(X1);
+			func.apply(j, c1, d1);
+			for (i = 0; i < 2; i++)
+			{
+				j = func.step(X2);
+				func.apply(j, c2, d2);
+			}
+			iterations++;
+		} while (X1 != X2);
+	}
+	work_time = (clock() - work_time) / (double)CLOCKS_PER_SEC;
+
+	return crackRoutines::solve_collision(c1, d1, c2, d2, order, result);
+}
+
+// Pollards rho-method with many walks advanced in lock-step (see rhobatch), collisions are found through distinguished points.
+// Number of walks and distinguished point criterion follow expected number of steps, so a collision is noticed soon after it happens.
+// Large subgroups are searched by several threads (see set_thread_count): each of them advances its own batch of walks,
+// distinguished points of all threads go to one lock-free store, and the thread that solves a collision stops the others.
+// With negation map (see set_negation_map) walks go over classes {P, -P}, on Koblitz curves - over {+-tau^i(P)} (see set_frobenius_map).
+bool crack::pollard_batch(const epoint &P, const epoint &Q, const bint &order, bint &result, int &iterations, double &work_time)
+{
+	fbpoint combs[2];
+	combs[0].assign(P);
+	combs[1].assign(Q);
+	iterfunc func(combs, order, set_count, doubling_count, partition);
+
+	double steps = crackRoutines::expected_steps(order);
+	bint lambda;
+	int orbit = negation_map && frobenius_map ? crackRoutines::frobenius_eigenvalue(P, order, lambda) : 0;
+	if (negation_map) steps /= sqrt(2.0);
+	if (orbit > 1) steps /= sqrt((double)orbit);
+	int threads = thread_count > 0 ? thread_count : (int)std::thread::hardware_concurrency();
+	threads = (int)min((double)max(threads, 1), max(1.0, steps / POLLARD_THREAD_STEPS));
+	int walks = (int)min((double)POLLARD_BATCH_WALKS, max(1.0, steps / threads / POLLARD_BATCH_WALK_STEPS));
+	int bits = crackRoutines::distinguished_bits(steps, walks * threads, dp_bits);
+
+	dpstore store((int)min(steps * 2 / (1 << bits), (double)POLLARD_DP_CAPACITY * POLLARD_DP_PRESIZE) + POLLARD_DP_CAPACITY);
+	prng &generator = prng::global();
+	rhosearch search;
+	search.curve = &P.get_curve();
+	search.combs = combs;
+	search.func = &func;
+	search.order = &order;
+	search.walks = walks;
+	search.negation = negation_map;
+	search.lambda = orbit > 1 ? &lambda : 0;
+	search.middle = 0;
+	search.mask = ((1 << bits) - 1) << POLLARD_DP_SHIFT;
+	search.maxLength = POLLARD_DP_MAX_LENGTH << bits;
+	search.maxIterations = POLLARD_MAX_EXPECTED * steps + (double)walks * threads * search.maxLength;
+	search.generator = generator.split(((unsigned long long)generator.next() << 32) | generator.next());
+	search.store = &store;
+	search.stop = false;
+	search.iterations = 0;
+	search.solved = false;
+
+	work_time = crackRoutines::wall_clock();
+	run_threads(&search, threads, pollard_batch_thread);
+	work_time = crackRoutines::wall_clock() - work_time;
+
+	iterations = (int)min((long long)INT_MAX, search.iterations.load());
+	if (search.solved) result = search.result;
+
+	return search.solved;
+}
+
+// Runs worker in threads threads (the calling thread is thread 0) and waits for all of them.
+void crack::run_threads(rhosearch *search, int threads, void (*worker)(rhosearch *, int))
+{
+	int i;
+	std::thread *workers = new std::thread[threads - 1];
+	for (i = 1; i < threads; i++)
+		workers[i - 1] = std::thread(worker, search, i);
+	worker(search, 0);
+	for (i = 1; i < threads; i++)
+		workers[i - 1].join();
+	delete[] workers;
+}
+
+// Runs one thread of batched rho-method: advances a batch of walks, that start from the thread's own seed stream,
+// until a collision is solved or the search is stopped (by another thread or by the iteration limit).
+void crack::pollard_batch_thread(rhosearch *search, int thread)
+{
+	int i;
+	const bint &order = *search->order;
+	const ecurve &curve = *search->curve;
+	int walks = search->walks;
+
+	// Seed stream S + k * T
+	prng generator = search->generator.split(thread);
+	epoint S(curve), T(curve);
+	bint sc, sd, tc, td;
+	bint scalars[2];
+	sc.random_mod(order, generator); sd.random_mod(order, generator);
+	tc.random_mod(order, generator); td.random_mod(order, generator);
+	scalars[0] = sc; scalars[1] = sd;
+	eccOperations::mul(search->combs, scalars, 2, S);
+	scalars[0] = tc; scalars[1] = td;
+	eccOperations::mul(search->combs, scalars, 2, T);
+
+	rhobatch batch(*search->func, walks, search->negation);
+	if (search->lambda != 0)
+		batch.set_frobenius(*search->lambda);
+	batch.set_seed(S, sc, sd, T, tc, td);
+	for (i = 0; i < walks; i++)
+		batch.restart(i);
+
+	rhobatch *batches = &batch;
+	walk_batches(search, &batches, 1);
+}
+
+// Advances count batches of walks in turn, until a collision is solved or the search is stopped (by another thread or by the iteration limit).
+// Distinguished points go to the shared store. Walks, whose collision is useless, are restarted (kangaroos - just ahead of their current point).
+void crack::walk_batches(rhosearch *search, rhobatch **batches, int count)
+{
+	int i, k;
+	const bint &order = *search->order;
+	cpoint key;
+	bint c, d;
+	while (!search->stop)
+	{
+		for (k = 0; k < count && !search->stop; k++)
 		{
-			j = X2.f(POLLARD_SET_ARG);
-			X2 += R[j];
-			c2 += a[j]; if (c2 >= order) c2 -= order;
-			d2 += b[j]; if (d2 >= order) d2 -= order;
+			rhobatch &batch = *batches[k];
+			int walks = batch.get_walks();
+			batch.step();
+			if ((search->iterations += walks) >= search->maxIterations)
+				search->stop = true;
+			for (i = 0; i < walks && !search->stop; i++)
+			{
+				const epoint &X = batch.get_point(i);
+				if (X.is_inf())
+					batch.restart(i);
+				else if (X.f(search->mask) == 0)
+				{
+					batch.get_coefficients(i, c, d);
+					if (key.from_epoint(X) != pE_OK)
+					{
+						batch.restart(i);
+						continue;
+					}
+					const dpentry *old = search->store->insert(key, c, d);
+					if (old == 0)
+						continue;
+					if (crackRoutines::solve_collision(old->c, old->d, c, d, order, c))
+					{
+						if (!search->solved.exchange(true))
+							search->result = c;
+						search->stop = true;
+					}
+					else
+					{
+						if (search->middle != 0)
+							batch.advance_seed(i);
+						batch.restart(i);
+					}
+				}
+				else if (batch.get_length(i) > search->maxLength)
+					batch.restart(i);
+			}
 		}
+	}
+}
+
+// Returns true if ECDLP in a group of order order is solved by baby-step giant-step method rather than by rho-method:
+// always in tiny groups, and in small groups (see POLLARD_BSGS_MAX_ORDER), when it is expected to take no more steps.
+bool crack::use_bsgs(const bint &order)
+{
+	return order < POLLARD_MIN_ORDER || (order <= POLLARD_BSGS_MAX_ORDER &&
+		crackRoutines::bsgs_steps(order, bsgs_budget) <= crackRoutines::expected_steps(order));
+}
+
+// Runs one thread of kangaroo method: advances a tame and a wild herd until a collision is solved or the search is stopped.
+// Herds start at a random distance below spread from their origin, kangaroos of a herd start a random distance apart.
+// Kangaroos, that land on the trail of their own herd, follow it and are restarted.
+void crack::kangaroo_thread(rhosearch *search, int thread)
+{
+	int i, k;
+	const bint &order = *search->order;
+	const ecurve &curve = *search->curve;
+	int walks = search->walks;
+
+	prng generator = search->generator.split(thread);
+	bint one(1);
+	bint spacing = search->spread / bint(walks);
+	if (spacing < one) spacing = one;
+
+	rhobatch tame(*search->func, walks), wild(*search->func, walks);
+	rhobatch *batches[2] = { &tame, &wild };
+	epoint S(curve), T(curve);
+	bint u, v, zero;
+	bint scalars[2];
+	for (k = 0; k < 2; k++)
+	{
+		u.random_mod(search->spread, generator);
+		v.random_mod(spacing, generator);
+		v += one;
+		// Tame herd starts at (middle + u) * P, wild one at u * P + Q.
+		scalars[0] = k == 0 ? (*search->middle + u) % order : u;
+		scalars[1] = k == 0 ? zero : one;
+		eccOperations::mul(search->combs, scalars, 2, S);
+		eccOperations::mul(search->combs[0], v, T);
+		batches[k]->set_seed(S, scalars[0], scalars[1], T, v, zero);
+		for (i = 0; i < walks; i++)
+			batches[k]->restart(i);
+	}
+
+	walk_batches(search, batches, 2);
+}
+
+// Pollards rho-method with a single walk, collisions are found through distinguished points.
+// Walk continues after every distinguished point, so a collision is found, when the walk passes a stored point again (after closing its cycle).
+// Each step costs one addition, coefficients of additive functions are updated only at distinguished points.
+bool crack::pollard_dp(const epoint &P, const epoint &Q, const bint &order, bint &result, int &iterations, double &work_time)
+{
+	int j;
+	const ecurve &curve = P.get_curve();
+
+	fbpoint combs[2];
+	bint scalars[2];
+	combs[0].assign(P);
+	combs[1].assign(Q);
+	iterfunc func(combs, order, set_count, doubling_count, partition);
+	bool additive = func.is_additive();
+	int *counts = new int[func.get_set_count()];
+
+	double steps = crackRoutines::expected_steps(order);
+	int bits = crackRoutines::distinguished_bits(steps, 1, dp_bits);
+	int mask = ((1 << bits) - 1) << POLLARD_DP_SHIFT;
+	int maxLength = POLLARD_DP_MAX_LENGTH << bits;
+	double maxIterations = POLLARD_MAX_EXPECTED * steps + maxLength;
+
+	epoint X(curve);
+	bint c, d;
+	int length = 0;
+	dpstore store(POLLARD_DP_CAPACITY);
+	cpoint key;
+	bool solved = false, restart = true;
+	work_time = clock();
+	while (!solved && iterations < maxIterations)
+	{
+		if (restart)
+		{
+			c.random_mod(order);
+			d.random_mod(order);
+			scalars[0] = c; scalars[1] = d;
+			eccOperations::mul(combs, scalars, 2, X);
+			for (j = 0; j < func.get_set_count(); j++)
+				counts[j] = 0;
+			length = 0;
+			restart = false;
+		}
+		j = func.step(X);
+		if (additive)
+			counts[j]++;
+		else
+			func.apply(j, c, d);
+		length++;
 		iterations++;
-	} while (X1 != X2);
+		if (X.f(mask) == 0)
+		{
+			if (additive)
+				func.apply_counts(counts, c, d);
+			length = 0;
+			if (key.from_epoint(X) != pE_OK)
+			{
+				restart = true;
+				continue;
+			}
+			const dpentry *old = store.insert(key, c, d);
+			if (old != 0)
+			{
+				solved = crackRoutines::solve_collision(old->c, old->d, c, d, order, result);
+				if (!solved) restart = true;
+			}
+		}
+		else if (length > maxLength)
+			restart = true;
+	}
 	work_time = (clock() - work_time) / (double)CLOCKS_PER_SEC;
 
-	delete[] a;
-	delete[] b;
-	delete[] R;
+	delete[] counts;
 
-	c1 -= c2; if (c1.is_less_zero()) c1 += order;
-	d2 -= d1; if (d2.is_less_zero()) d2 += order;
-	if (d2.is_zero()) return false;
-	bintOperations::inv(d2, order, d1);
-	if (d1.is_less_zero()) d1 += order;
-	result = (c1 * d1) % order;
-	return true;
+	return solved;
+}
+
+// Pollards rho-method with a single walk and Brent's cycle finding.
+// Walk is compared with a saved point, which is moved to the current point after 1, 2, 4, ... steps.
+// Each step costs one addition and memory does not grow, coefficients of additive functions are updated only when the saved point moves.
+bool crack::pollard_brent(const epoint &P, const epoint &Q, const bint &order, bint &result, int &iterations, double &work_time)
+{
+	int j;
+	const ecurve &curve = P.get_curve();
+
+	fbpoint combs[2];
+	bint scalars[2];
+	combs[0].assign(P);
+	combs[1].assign(Q);
+	iterfunc func(combs, order, set_count, doubling_count, partition);
+	bool additive = func.is_additive();
+	int *counts = new int[func.get_set_count()];
+	double maxIterations = POLLARD_MAX_EXPECTED * crackRoutines::expected_steps(order);
+
+	// Coefficients c and d belong to saved point S, steps made since are counted (or tracked in c2 and d2)
+	epoint X(curve), S(curve);
+	bint c, d, c2, d2;
+	c.random_mod(order);
+	d.random_mod(order);
+	scalars[0] = c; scalars[1] = d;
+	eccOperations::mul(combs, scalars, 2, X);
+	S = X;
+	c2 = c; d2 = d;
+	for (j = 0; j < func.get_set_count(); j++)
+		counts[j] = 0;
+	int length = 0, limit = 1;
+	bool solved = false;
+	work_time = clock();
+	while (iterations < maxIterations)
+	{
+		j = func.step(X);
+		if (additive)
+			counts[j]++;
+		else
+			func.apply(j, c2, d2);
+		length++;
+		iterations++;
+		if (X == S)
+		{
+			if (additive)
+			{
+				c2 = c; d2 = d;
+				func.apply_counts(counts, c2, d2);
+			}
+			solved = crackRoutines::solve_collision(c, d, c2, d2, order, result);
+			break;
+		}
+		if (length == limit)
+		{
+			if (additive)
+				func.apply_counts(counts, c, d);
+			else
+			{
+				c = c2; d = d2;
+			}
+			S = X;
+			length = 0;
+			if (limit < (1 << 30)) limit <<= 1;
+		}
+	}
+	work_time = (clock() - work_time) / (double)CLOCKS_PER_SEC;
+
+	delete[] counts;
+
+	return solved;
 }
@@ -2,12 +2,17 @@
 #define _CRACK_H
 
 #include "../ecc/epoint.h"
+#include "../ecc/fbpoint.h"
 #include "../ecc/bint.h"
 
 /* Need some classes */
 class ecurve;
 class epoint;
 class bint;
+class iterfunc;
+class rhobatch;
+struct rhosearch;
+struct phsearch;
 
 typedef struct
 {
@@ -16,11 +21,56 @@ typedef struct
 	int k;    // factors power
 } pofactor;
 
+// Precomputed Garner's reconstruction plan for a fixed set of prime-power moduli.
+// Built once per factorization, it turns every reconstruction into a few modular multiplications.
+class crtplan
+{
+public:
+	/* Constructors */
+	crtplan(const pofactor *factors, int n, const bint &N);
+
+	/* Destructors */
+	~crtplan();
+
+	/* Accessor methods */
+	int get_count(void) const;
+	const bint &get_modulus(int i) const;
+
+	/* Reconstruction methods */
+	bint reconstruct(const bint *residues) const;
+	bint reconstruct(const pofactor *factors) const;
+	void reconstruct(const bint *residues, int count, bint *results) const;
+
+private:
+	crtplan(const crtplan &plan);
+	void operator= (const crtplan &plan);
+
+	int n;
+	bint N;
+	bint *m;       // moduli p[i] ^ k[i]
+	bint *prefix;  // products m[0] * ... * m[i - 1]
+	bint *inverse; // inverses of prefix[i] modulo m[i]
+};
+
 namespace crackRoutines
 {
 	void op_err(int err);
+	double wall_clock(void);
 	bint chinese_remainder_theorem(const pofactor *factors, int n, const bint &N);
 	pofactor *calculate_point_order_factorization(const epoint &point, int &factor_count);
+	void apply_counts(const bint *a, const bint *b, int set_count, const bint &order, int *counts, bint &c, bint &d);
+	void replay_walk(const iterfunc &func, int length, epoint &X, bint &c, bint &d, bool negation);
+	void generate_iteration_function(const fbpoint *combs, const bint &order, int set_count, epoint *R, bint *a, bint *b);
+	void generate_kangaroo_jumps(const fbpoint &comb, const bint &order, double mean, int set_count, epoint *R, bint *a, bint *b);
+	double to_double(const bint &n);
+	bint from_double(double n);
+	double expected_steps(const bint &order);
+	double kangaroo_steps(const bint &width);
+	double bsgs_steps(const bint &order, int budget);
+	double pohlig_hellman_steps(const pofactor *factors, int n, bool negation);
+	int distinguished_bits(double steps, int walks, int dp_bits);
+	bool solve_collision(bint c1, bint d1, bint c2, bint d2, const bint &order, bint &result);
+	int frobenius_eigenvalue(const epoint &P, const bint &order, bint &lambda);
 }
 
 class crack
@@ -30,13 +80,19 @@ public:
 	crack(const ecurve &curve);
 	crack(const ecurve &curve, const epoint &G, const epoint &xG);
 
+	/* Destructors */
+	~crack();
+
 	/* Setter methods */
 	void set_G(const epoint &G);
 	void set_xG(const epoint &xG);
+	void set_interval(const bint &lo, const bint &hi);
+	void clear_interval(void);
 
 	/* Accessor methods */
 	const epoint &get_G(void);
 	const epoint &get_xG(void);
+	bool get_interval(bint &lo, bint &hi);
 
 	/* Helper methods */
 	bool is_running(void);
@@ -44,15 +100,81 @@ public:
 	/* Control methods */
 	bool solve(bint &result, bool verbose, char *offset, double &work_time);
 
+	/* Configuration methods */
+	static void set_solve_mode(int mode);
+	static int get_solve_mode(void);
+	static void set_walk_mode(int mode);
+	static int get_walk_mode(void);
+	static void set_search_mode(int mode);
+	static int get_search_mode(void);
+	static void set_dp_bits(int bits);
+	static int get_dp_bits(void);
+	static void set_thread_count(int count);
+	static int get_thread_count(void);
+	static void set_negation_map(bool enabled);
+	static bool get_negation_map(void);
+	static void set_frobenius_map(bool enabled);
+	static bool get_frobenius_map(void);
+	static void set_set_count(int count);
+	static int get_set_count(void);
+	static void set_doubling_count(int count);
+	static int get_doubling_count(void);
+	static void set_partition(int partition);
+	static int get_partition(void);
+	static void set_bsgs_budget(int budget);
+	static int get_bsgs_budget(void);
+
 	/* Solution methods */
 	static bool pollard(const epoint &P, const epoint &Q, const bint &order, bint &result, int &iterations, double &work_time);
 	static bool bruteforce(const epoint &P, const epoint &Q, const bint &order, bint &result, int &iterations, double &work_time);
+	static bool bsgs(const epoint &P, const epoint &Q, const bint &order, bint &result, int &iterations, double &work_time);
+	static bool kangaroo(const epoint &P, const epoint &Q, const bint &order, const bint &lo, const bint &hi, bint &result, int &iterations, double &work_time);
 
 private:
+	crack(const crack &cracker);
+	void operator= (const crack &cracker);
+
+	/* Collision search methods */
+	static bool pollard_floyd(const epoint &P, const epoint &Q, const bint &order, bint &result, int &iterations, double &work_time);
+	static bool pollard_batch(const epoint &P, const epoint &Q, const bint &order, bint &result, int &iterations, double &work_time);
+	static bool pollard_dp(const epoint &P, const epoint &Q, const bint &order, bint &result, int &iterations, double &work_time);
+	static bool pollard_brent(const epoint &P, const epoint &Q, const bint &order, bint &result, int &iterations, double &work_time);
+	static void pollard_batch_thread(rhosearch *search, int thread);
+	static void kangaroo_thread(rhosearch *search, int thread);
+	static void run_threads(rhosearch *search, int threads, void (*worker)(rhosearch *, int));
+	static void walk_batches(rhosearch *search, rhobatch **batches, int count);
+	static bool use_bsgs(const bint &order);
+
+	/* Solution methods */
+	bool solve_kangaroo(const bint &order, bint &result, bool verbose, char *offset);
+	static bool solve_prime_power(phsearch *search, int shift, int e, const epoint &h, bint &result);
+	static bool solve_digit(phsearch *search, const epoint &h, bint &result);
+
+	static int solve_mode;
+	static int walk_mode;
+	static int search_mode;
+	static int dp_bits;
+	static int thread_count;
+	static bool negation_map;
+	static bool frobenius_map;
+	static int set_count;
+	static int doubling_count;
+	static int partition;
+	static int bsgs_budget;
 
 	bool running;
 
 	const ecurve *curve;
 	epoint G, xG;
+
+	// Comb tables of G, shared by all multiplications of G.
+	fbpoint Gcomb;
+
+	// Reconstruction plan for G order factorization (built on first solve).
+	crtplan *plan;
+
+	// Interval known to hold the solution (see set_interval).
+	bool bounded;
+	bint lo, hi;
 };
 #endif
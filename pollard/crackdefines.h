@@ -27,14 +27,136 @@
 // Format used for printing time in verbose mode.
 #define PRINT_FORMAT         "%.5lf"
 
-// Minimum group order required to run Pollards rho-method. It must be a big intger.
+// Minimum group order required to run Pollards rho-method (smaller groups are solved by baby-step giant-step method). It must be a big intger.
 #define POLLARD_MIN_ORDER    bint(1000)
 
-// Number of sets used in Pollards rho-method.
-#define POLLARD_SET_COUNT    16
+// Number of sets of iteration function used in Pollards rho-method, see iterfunc (with 16 sets walks are a bit slower than random ones, with 20 - close to them).
+#define POLLARD_SET_COUNT    20
 
-// This argument is passed to epoint objects' f method (which is a bitwise and).
-// The result of f fuction must be no more than POLLARD_SET_COUNT constant.
-#define POLLARD_SET_ARG      0xF
+// Number of iteration function sets, that double points (Teske's mixed walk), the rest add points. Walks with doublings update coefficients on every step.
+#define POLLARD_DOUBLING_COUNT 0
+
+// Partition choosing sets of iteration function (one of POLLARD_PARTITION_* constants).
+#define POLLARD_PARTITION    POLLARD_PARTITION_HASH
+
+// Method solving ECDLP, when the solution is known to lie in an interval (one of POLLARD_SOLVE_* constants), see crack::set_interval.
+#define POLLARD_SOLVE_MODE   POLLARD_SOLVE_AUTO
+
+// Walk mode used by Pollards rho-method by default (one of POLLARD_WALK_* constants).
+// Replaying walks costs an extra pass over the walk, so it only pays off when coefficient arithmetics is expensive.
+#define POLLARD_WALK_MODE    POLLARD_WALK_TRACKED
+
+// Collision search used by Pollards rho-method by default (one of POLLARD_SEARCH_* constants).
+#define POLLARD_SEARCH_MODE  POLLARD_SEARCH_BATCH
+
+// Number of criterion bits of distinguished points: a point is distinguished, when these bits of its packed x are zero.
+// Negative value lets the criterion follow expected number of steps.
+#define POLLARD_DP_BITS      -1
+
+// Number of threads running batched rho-method (0 - one per hardware thread).
+#define POLLARD_THREADS      0
+
+// Batched rho-method walks on classes {P, -P} by default (1 - yes, 0 - no), see crack::set_negation_map.
+#define POLLARD_NEGATION_MAP 1
+
+// Batched rho-method on Koblitz curves walks on classes {+-tau^i(P)} by default (1 - yes, 0 - no), see crack::set_frobenius_map.
+// Off: class representatives cost m Frobenius maps per step and tracked walks, which outweighs the sqrt(m) gain on small fields.
+#define POLLARD_FROBENIUS_MAP 0
+
+/************************************/
+/* Batched rho-method configuration */
+/************************************/
+
+// Maximum number of walks advanced in lock-step (they share one field division per step).
+#define POLLARD_BATCH_WALKS      512
+
+// Minimum expected number of steps of a single walk (small subgroups get fewer walks).
+#define POLLARD_BATCH_WALK_STEPS 256
+
+// Expected walk length is split into about this many distinguished point intervals.
+// Larger values find collisions sooner after they happen, but store more points.
+#define POLLARD_DP_SPACING       8
+
+// Maximum number of criterion bits of distinguished points.
+#define POLLARD_DP_MAX_BITS      24
+
+// Distinguished point criterion skips this many lowest bits of x (with bit partition they choose the set of the next step).
+#define POLLARD_DP_SHIFT         4
+
+// Walks, that do not reach a distinguished point in this many expected intervals, are restarted (they are likely trapped in a cycle).
+#define POLLARD_DP_MAX_LENGTH    20
+
+// Initial capacity of distinguished point store (it grows when needed).
+#define POLLARD_DP_CAPACITY      1024
+
+// Store is presized for the expected number of distinguished points, but to at most this many times POLLARD_DP_CAPACITY.
+#define POLLARD_DP_PRESIZE       64
+
+// Distinguished point searches give up after this many expected numbers of steps.
+#define POLLARD_MAX_EXPECTED     16
+
+// Minimum expected number of steps per thread (small subgroups are searched by fewer threads, starting them would cost more than they save).
+#define POLLARD_THREAD_STEPS     65536
+
+/***********************************************/
+/* Baby-step giant-step method configuration */
+/***********************************************/
+
+// Maximum number of baby steps stored (the table takes 16 bytes per step), see crack::set_bsgs_budget.
+#define POLLARD_BSGS_BUDGET      (1 << 20)
+
+// Maximum group order solved by baby-step giant-step method instead of Pollards rho-method (2 ^ 40). It must be a big integer.
+// Smaller groups are solved by it, when it is expected to take no more steps than rho-method (see crackRoutines::bsgs_steps).
+#define POLLARD_BSGS_MAX_ORDER   bint((char *)"1099511627776")
+
+// Number of baby or giant steps made at once (they share one field division).
+#define POLLARD_BSGS_BATCH       256
+
+/******************************/
+/* Negation map configuration */
+/******************************/
+
+// Walks on classes {P, -P} remember their point every this many steps: coming back to it reveals a fruitless cycle,
+// which is left by doubling its least point. Longer cycles are very rare and end with the walk restart.
+#define POLLARD_CYCLE_WINDOW     32
+
+/*************************************/
+/* Enum-like constants configuration */
+/*************************************/
+/* Do not edit this                  */
+/*************************************/
+
+// Solve mode: kangaroo method runs, when its expected number of steps is below the one of Pohlig-Hellman algorithm.
+#define POLLARD_SOLVE_AUTO           0
+
+// Solve mode: Pohlig-Hellman algorithm always runs (interval is ignored).
+#define POLLARD_SOLVE_POHLIG_HELLMAN 1
+
+// Solve mode: kangaroo method always runs, when interval is known.
+#define POLLARD_SOLVE_KANGAROO       2
+
+// Walk mode: coefficients c and d of the current point are updated on every step.
+#define POLLARD_WALK_TRACKED 0
+
+// Walk mode: only walks' starting seed and step count are kept, coefficients are recovered by replaying the walk on collision.
+#define POLLARD_WALK_REPLAY  1
+
+// Collision search: single walk with Floyd's cycle finding (walk mode applies).
+#define POLLARD_SEARCH_FLOYD 0
+
+// Collision search: many walks advanced in lock-step, collisions are found through distinguished points.
+#define POLLARD_SEARCH_BATCH 1
+
+// Collision search: single walk, collisions are found through distinguished points (one addition per step).
+#define POLLARD_SEARCH_DP    2
+
+// Collision search: single walk with Brent's cycle finding (one addition per step, constant memory).
+#define POLLARD_SEARCH_BRENT 3
+
+// Partition: set is chosen by the lowest bits of x (x modulo number of sets, when it is not a power of two).
+#define POLLARD_PARTITION_BITS 0
+
+// Partition: set is chosen by hash of x (see epoint::hash).
+#define POLLARD_PARTITION_HASH 1
 
 #endif
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "dpstore.h"
+
+/* dpstore class */
+
+/* Static variables */
+
+const unsigned int dpstore::closed;
+
+/* Constructors */
+
+// Creates an empty store with room for at least capacity points (it grows when needed).
+dpstore::dpstore(int capacity)
+{
+	int size = 16;
+	while (size < 2 * capacity)
+		size <<= 1;
+	first = create_level(size);
+}
+
+/* Destructors */
+
+// Frees stored points.
+dpstore::~dpstore()
+{
+	delete_levels(first);
+}
+
+/* Accessor methods */
+
+// Returns number of stored points (while other threads insert, the result is approximate).
+int dpstore::get_count(void) const
+{
+	int count = 0;
+	for (level *table = first; table != 0; table = table->next.load())
+		count += table->count.load();
+	return count;
+}
+
+/* Modification methods */
+
+// Stores point key with coefficients c and d (and length of the walk from c * P + d * Q to the point).
+// If the point is already stored, nothing is changed and the stored entry is returned, otherwise - null pointer.
+// May be called from many threads at once. Returned entries stay valid until the store is cleared or destroyed.
+const dpentry *dpstore::insert(const cpoint &key, const bint &c, const bint &d, int length)
+{
+	unsigned int hash = key.hash();
+	bool inserted = false;
+	level *table = first;
+	while (true)
+	{
+		const dpentry *old = find_or_insert(table, key, hash, c, d, length, inserted);
+		if (old != 0 || inserted)
+			return old;
+
+		// The level is full - go on to the next one (creating it, unless another thread already did).
+		level *next = table->next.load();
+		if (next == 0)
+		{
+			level *created = create_level(2 * table->capacity);
+			if (table->next.compare_exchange_strong(next, created))
+				next = created;
+			else
+				delete_levels(created);
+		}
+		table = next;
+	}
+}
+
+// Removes all stored points. Must not be called while other threads use the store.
+void dpstore::clear(void)
+{
+	delete_levels(first->next.load());
+	first->next = 0;
+	first->count = 0;
+	for (int i = 0; i < first->capacity; i++)
+		first->tags[i] = 0;
+}
+
+/* Internal methods */
+
+// Allocates an empty level of capacity slots.
+dpstore::level *dpstore::create_level(int capacity)
+{
+	level *table = new level;
+	table->capacity = capacity;
+	table->limit = capacity / 2;
+	table->count = 0;
+	table->tags = new std::atomic<unsigned int>[capacity];
+	table->slots = new dpentry[capacity];
+	table->next = 0;
+	for (int i = 0; i < capacity; i++)
+		table->tags[i] = 0;
+	return table;
+}
+
+// Frees level first and all levels chained after it.
+void dpstore::delete_levels(level *first)
+{
+	while (first != 0)
+	{
+		level *next = first->next.load();
+		delete [] first->tags;
+		delete [] first->slots;
+		delete first;
+		first = next;
+	}
+}
+
+// Returns tag of a record being written for key hash hash (non-zero and even, ready bit is added when the record is written).
+unsigned int dpstore::tag(unsigned int hash)
+{
+	hash &= ~1u;
+	return hash != 0 ? hash : 2;
+}
+
+// Looks for key in level table. If it is not there and the level is not full, stores the record and sets inserted.
+// The first empty slot on the way is claimed by CAS either for the record or, if the level is full, as closed. Either way every
+// thread, looking for the same key, sees the same decision, so the key is stored in one level only.
+// Returns stored entry with the same key or null pointer.
+const dpentry *dpstore::find_or_insert(level *table, const cpoint &key, unsigned int hash, const bint &c, const bint &d, int length, bool &inserted)
+{
+	unsigned int writing = tag(hash);
+	int mask = table->capacity - 1;
+	int i = hash & mask;
+	for (int probes = 0; probes < table->capacity; probes++)
+	{
+		unsigned int current = table->tags[i].load(std::memory_order_acquire);
+		if (current == 0)
+		{
+			// Slots are never emptied, so the key is not in this level.
+			bool full = table->count.load() >= table->limit;
+			if (table->tags[i].compare_exchange_strong(current, full ? closed : writing, std::memory_order_acquire))
+			{
+				if (full)
+					return 0;
+				table->count.fetch_add(1);
+				dpentry &entry = table->slots[i];
+				entry.key = key;
+				entry.c = c;
+				entry.d = d;
+				entry.length = length;
+				table->tags[i].store(writing | 1, std::memory_order_release);
+				inserted = true;
+				return 0;
+			}
+			// Another thread took the slot first - check its tag.
+		}
+		if (current == closed)
+			return 0;
+		if ((current | 1) == (writing | 1))
+		{
+			while (!(current & 1))
+				current = table->tags[i].load(std::memory_order_acquire);
+			if (table->slots[i].key == key)
+				return &table->slots[i];
+		}
+		i = (i + 1) & mask;
+	}
+	return 0;
+}
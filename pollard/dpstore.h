@@ -0,0 +1,62 @@
+#ifndef _DPSTORE_H
+#define _DPSTORE_H
+
+#include <atomic>
+#include "../ecc/cpoint.h"
+#include "../ecc/bint.h"
+
+// Distinguished point together with its coefficients: point = c * P + d * Q.
+typedef struct
+{
+	cpoint key;
+	bint c;
+	bint d;
+	int length; // number of steps from point c * P + d * Q to the stored point (0 - coefficients belong to the point itself)
+} dpentry;
+
+// Store of distinguished points: lock-free open-addressing hash table keyed by compact points.
+// Every slot has a tag - a fingerprint of the key with a ready bit. Inserting thread claims an empty slot by CAS on its tag,
+// writes the record in place and then sets the ready bit, so the store may be shared by many threads without locks.
+// A full table is not rehashed: a twice larger level is chained after it, so stored records never move. Empty slots, that
+// keys reach once the level is full, are closed by CAS too, so a key never lands in two levels.
+class dpstore
+{
+public:
+	/* Constructors */
+	dpstore(int capacity);
+
+	/* Destructors */
+	~dpstore();
+
+	/* Accessor methods */
+	int get_count(void) const;
+
+	/* Modification methods */
+	const dpentry *insert(const cpoint &key, const bint &c, const bint &d, int length = 0);
+	void clear(void);
+
+private:
+	dpstore(const dpstore &store);
+	void operator= (const dpstore &store);
+
+	// One table of the chain.
+	struct level
+	{
+		int capacity;                      // always a power of two
+		int limit;                         // maximum number of records (load factor 1/2)
+		std::atomic<int> count;
+		std::atomic<unsigned int> *tags;   // 0 - empty slot, 1 - closed slot, even - record is being written, other odd - record is ready
+		dpentry *slots;
+		std::atomic<level *> next;
+	};
+
+	/* Internal methods */
+	static level *create_level(int capacity);
+	static void delete_levels(level *first);
+	static unsigned int tag(unsigned int hash);
+	static const unsigned int closed = 1;
+	const dpentry *find_or_insert(level *table, const cpoint &key, unsigned int hash, const bint &c, const bint &d, int length, bool &inserted);
+
+	level *first;
+};
+#endif
@@ -0,0 +1,140 @@
+#include "iterfunc.h"
+#include "crack.h"
+#include "crackdefines.h"
+
+/* iterfunc class */
+
+/* Constructors */
+
+// Creates random iteration function of setCount sets (the first doublings of them double points) in a group of order order,
+// where combs hold P and Q. Sets are chosen by partition (one of POLLARD_PARTITION_* constants).
+iterfunc::iterfunc(const fbpoint *combs, const bint &order, int setCount, int doublings, int partition)
+	: order(order)
+{
+	init(setCount, doublings, partition);
+	crackRoutines::generate_iteration_function(combs, order, this->setCount, R, a, b);
+}
+
+// Creates iteration function of setCount sets with given table R[j] = a[j] * P + b[j] * Q (the table is copied).
+iterfunc::iterfunc(const epoint *R, const bint *a, const bint *b, const bint &order, int setCount, int doublings, int partition)
+	: order(order)
+{
+	init(setCount, doublings, partition);
+	for (int i = 0; i < this->setCount; i++)
+	{
+		this->R[i] = R[i];
+		this->a[i] = a[i];
+		this->b[i] = b[i];
+	}
+}
+
+/* Destructors */
+
+// Frees the table.
+iterfunc::~iterfunc()
+{
+	delete [] R;
+	delete [] a;
+	delete [] b;
+}
+
+/* Accessor methods */
+
+// Returns number of sets.
+int iterfunc::get_set_count(void) const
+{
+	return setCount;
+}
+
+// Returns number of doubling sets.
+int iterfunc::get_doublings(void) const
+{
+	return doublings;
+}
+
+// Returns partition choosing sets (one of POLLARD_PARTITION_* constants).
+int iterfunc::get_partition(void) const
+{
+	return partition;
+}
+
+// Returns order of the group.
+const bint &iterfunc::get_order(void) const
+{
+	return order;
+}
+
+// Returns table of points added by steps (indexed by table_index).
+const epoint *iterfunc::get_table(void) const
+{
+	return R;
+}
+
+// Returns true if the function has no doubling sets (coefficients may be updated by apply_counts).
+bool iterfunc::is_additive(void) const
+{
+	return doublings == 0;
+}
+
+/* Iteration methods */
+
+// Returns set of point X.
+int iterfunc::select(const epoint &X) const
+{
+	if (partition == POLLARD_PARTITION_HASH)
+		return (int)(((unsigned long long)X.hash() * setCount) >> 32);
+	if (mask != 0)
+		return X.f(mask);
+	return (int)((unsigned int)X.f(-1) % setCount);
+}
+
+// Returns index of the point added by a step of set set (see eccOperations::add_n), negative for doubling sets.
+int iterfunc::table_index(int set) const
+{
+	return set < doublings ? -1 : set;
+}
+
+// Advances point X by one step, returns set of the step.
+int iterfunc::step(epoint &X) const
+{
+	int j = select(X);
+	if (j < doublings)
+		X += X;
+	else
+		X += R[j];
+	return j;
+}
+
+// Updates coefficients c and d of a point (X = c * P + d * Q) by a step of set set.
+void iterfunc::apply(int set, bint &c, bint &d) const
+{
+	if (set < doublings)
+	{
+		c += c; if (c >= order) c -= order;
+		d += d; if (d >= order) d -= order;
+		return;
+	}
+	c += a[set]; if (c >= order) c -= order;
+	d += b[set]; if (d >= order) d -= order;
+}
+
+// Adds steps counted per set (counts holds setCount signed counters, which are reset) to coefficients c and d.
+// Only additive functions may be counted.
+void iterfunc::apply_counts(int *counts, bint &c, bint &d) const
+{
+	crackRoutines::apply_counts(a, b, setCount, order, counts, c, d);
+}
+
+/* Internal methods */
+
+// Sets configuration and allocates the table.
+void iterfunc::init(int setCount, int doublings, int partition)
+{
+	this->setCount = max(setCount, 2);
+	this->doublings = min(max(doublings, 0), this->setCount - 1);
+	this->partition = partition;
+	mask = (this->setCount & (this->setCount - 1)) == 0 ? this->setCount - 1 : 0;
+	R = new epoint[this->setCount];
+	a = new bint[this->setCount];
+	b = new bint[this->setCount];
+}
@@ -0,0 +1,54 @@
+#ifndef _ITERFUNC_H
+#define _ITERFUNC_H
+
+#include "../ecc/epoint.h"
+#include "../ecc/fbpoint.h"
+#include "../ecc/bint.h"
+
+// Iteration function of Pollards rho-method. Points are split into setCount sets by their x (see POLLARD_PARTITION_* constants),
+// a step from a point of set j goes to X + R[j] (R[j] = a[j] * P + b[j] * Q), or to 2 * X, if j is one of the first doublings sets
+// (Teske's mixed walk). Sets depend on x only, so X and -X always take the same set.
+// Without doubling sets the function is r-adding: coefficients of a walk may be updated once for many steps (see apply_counts).
+class iterfunc
+{
+public:
+	/* Constructors */
+	iterfunc(const fbpoint *combs, const bint &order, int setCount, int doublings, int partition);
+	iterfunc(const epoint *R, const bint *a, const bint *b, const bint &order, int setCount, int doublings, int partition);
+
+	/* Destructors */
+	~iterfunc();
+
+	/* Accessor methods */
+	int get_set_count(void) const;
+	int get_doublings(void) const;
+	int get_partition(void) const;
+	const bint &get_order(void) const;
+	const epoint *get_table(void) const;
+	bool is_additive(void) const;
+
+	/* Iteration methods */
+	int select(const epoint &X) const;
+	int table_index(int set) const;
+	int step(epoint &X) const;
+	void apply(int set, bint &c, bint &d) const;
+	void apply_counts(int *counts, bint &c, bint &d) const;
+
+private:
+	iterfunc(const iterfunc &func);
+	void operator= (const iterfunc &func);
+
+	/* Internal methods */
+	void init(int setCount, int doublings, int partition);
+
+	int setCount;
+	int doublings;
+	int partition;
+	int mask;      // setCount - 1, when lowest bits of x choose sets directly (0 - otherwise)
+	bint order;
+
+	epoint *R;     // setCount points, R[j] = a[j] * P + b[j] * Q (unused for doubling sets)
+	bint *a;
+	bint *b;
+};
+#endif
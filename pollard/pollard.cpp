@@ -7,6 +7,7 @@
 #include "../ecc/crypto.h"
 #include "../ecc/bint.h"
 #include "../ecc/helpers.h"
+#include "../ecc/prng.h"
 
 using namespace helpers;
 
@@ -36,7 +37,8 @@ void close_files(void)
 
 int main(void)
 {
-	srand((unsigned int)time(0));
+	prng::initialize(prng::default_seed());
+	std::cout << "[i] Random seed " << prng::get_run_seed() << "." << std::endl;
 	open_files();
 	field = read_field(fin);
 	std::cout << "[+] Created field (degree " << field->get_deg() << ")." << std::endl;
@@ -51,9 +53,11 @@ int main(void)
 		int message_length;
 		curve->order(curveOrder);
 		std::cout << "[+] Created elliptic curve (order " << curveOrder << ")." << std::endl;
-		epoint G = read_next_point(fin, *curve);
-		epoint aG = read_next_point(fin, *curve);
-		epoint bG = read_next_point(fin, *curve);
+		epoint points[3];
+		read_next_points(fin, *curve, 3, points);
+		epoint G = points[0];
+		epoint aG = points[1];
+		epoint bG = points[2];
 		pollard = new crack(*curve);
 		if (!G.check() || !aG.check() || !bG.check())
 		{
@@ -63,6 +67,10 @@ int main(void)
 		{
 			pollard->set_G(G);
 			pollard->set_xG(bG);
+			// Keys are chosen from the upper half of G group (see helpers::choose_key), so kangaroo method may search there.
+			bint groupOrder;
+			G.order(groupOrder);
+			pollard->set_interval(groupOrder / 2, groupOrder - bint(1));
 			bint solution;
 			double work_time;
 			if (!pollard->solve(solution, true, "    ", work_time))
@@ -0,0 +1,379 @@
+#include "rhobatch.h"
+#include "iterfunc.h"
+#include "crack.h"
+#include "crackdefines.h"
+#include "../ecc/eccoperations.h"
+#include "../ecc/ecurve.h"
+#include "../ecc/2nfactory.h"
+
+/* rhobatch class */
+
+/* Constructors */
+
+// Creates walks walks of iteration function func (it must outlive the batch).
+// With negation set walks go over classes {X, -X}. Walks must be started with restart after the seed stream is set.
+rhobatch::rhobatch(const iterfunc &func, int walks, bool negation)
+	: func(func), setCount(func.get_set_count()), order(func.get_order()), walks(walks), negation(negation)
+{
+	int i;
+	X = new epoint[walks];
+	c = new bint[walks];
+	d = new bint[walks];
+	counts = new int[walks * setCount];
+	length = new int[walks];
+	index = new int[walks];
+	moves = new int[walks];
+	tracked = !func.is_additive();
+	curC = new bint[walks];
+	curD = new bint[walks];
+	for (i = 0; i < walks * setCount; i++)
+		counts[i] = 0;
+	for (i = 0; i < walks; i++)
+		length[i] = 0;
+
+	signs = 0; tries = 0; pending = 0; next = 0; Y = 0;
+	mark = 0; least = 0; target = 0; age = 0; escaping = 0;
+	powers = 0; negated = 0;
+	frobenius = 0;
+	lambdaPowers = 0;
+	if (negation)
+	{
+		signs = new int[walks];
+		tries = new int[walks];
+		pending = new int[walks];
+		next = new int[walks];
+		Y = new epoint[walks];
+		mark = new lnum[walks];
+		least = new lnum[walks];
+		target = new lnum[walks];
+		age = new int[walks];
+		escaping = new bool[walks];
+		powers = new int[walks];
+		negated = new bool[walks];
+		for (i = 0; i < walks; i++)
+		{
+			signs[i] = 1;
+			age[i] = 0;
+			escaping[i] = false;
+		}
+	}
+}
+
+/* Destructors */
+
+// Frees walks.
+rhobatch::~rhobatch()
+{
+	delete [] X;
+	delete [] c;
+	delete [] d;
+	delete [] counts;
+	delete [] length;
+	delete [] index;
+	delete [] moves;
+	delete [] curC;
+	delete [] curD;
+	if (negation)
+	{
+		delete [] signs;
+		delete [] tries;
+		delete [] pending;
+		delete [] next;
+		delete [] Y;
+		delete [] mark;
+		delete [] least;
+		delete [] target;
+		delete [] age;
+		delete [] escaping;
+		delete [] powers;
+		delete [] negated;
+	}
+	if (lambdaPowers != 0)
+		delete [] lambdaPowers;
+}
+
+/* Accessor methods */
+
+// Returns number of walks.
+int rhobatch::get_walks(void) const
+{
+	return walks;
+}
+
+// Returns current point of walk walk.
+const epoint &rhobatch::get_point(int walk) const
+{
+	return X[walk];
+}
+
+// Returns number of steps walk walk made since it was started or its coefficients were requested.
+int rhobatch::get_length(int walk) const
+{
+	return length[walk];
+}
+
+// Saves coefficients of the current point of walk walk (X = c * P + d * Q) to c and d.
+// Counting restarts from this point.
+void rhobatch::get_coefficients(int walk, bint &c, bint &d)
+{
+	rebase(walk);
+	length[walk] = 0;
+	c = this->c[walk];
+	d = this->d[walk];
+}
+
+// Saves coefficients of the point, where counting of walk walk started, to c and d.
+// The walk reached its current point in get_length steps from there (replaying them from a fresh walk gives the same point,
+// see crackRoutines::replay_walk - it does not go over Frobenius classes).
+void rhobatch::get_start(int walk, bint &c, bint &d) const
+{
+	c = this->c[walk];
+	d = this->d[walk];
+}
+
+/* Walk methods */
+
+// Extends classes of walks to {+-tau^i(X)}, where tau(X) = lambda * X on the group (see crackRoutines::frobenius_eigenvalue).
+// Curve must be a Koblitz curve. Has no effect unless walks go over classes {X, -X}. Must be called before walks are started.
+void rhobatch::set_frobenius(const bint &lambda)
+{
+	if (!negation) return;
+	frobenius = func.get_table()[0].get_curve().get_field().get_deg();
+	tracked = true;
+	if (lambdaPowers != 0)
+		delete [] lambdaPowers;
+	lambdaPowers = new bint[frobenius];
+	lambdaPowers[0] = bint(1);
+	for (int i = 1; i < frobenius; i++)
+		lambdaPowers[i] = (lambdaPowers[i - 1] * lambda) % order;
+}
+
+// Sets seed stream: walks are started from points S + k * T = (sc + k * tc) * P + (sd + k * td) * Q.
+void rhobatch::set_seed(const epoint &S, const bint &sc, const bint &sd, const epoint &T, const bint &tc, const bint &td)
+{
+	this->S = S;
+	this->T = T;
+	this->sc = sc;
+	this->sd = sd;
+	this->tc = tc;
+	this->td = td;
+}
+
+// Starts walk walk from the next point of seed stream.
+void rhobatch::restart(int walk)
+{
+	int j;
+	X[walk] = S;
+	c[walk] = sc;
+	d[walk] = sd;
+	for (j = 0; j < setCount; j++)
+		counts[walk * setCount + j] = 0;
+	length[walk] = 0;
+	curC[walk] = sc;
+	curD[walk] = sd;
+	if (negation)
+	{
+		int power;
+		bool negatedStart = canonize(X[walk], power);
+		signs[walk] = 1;
+		apply_class(walk, power, negatedStart);
+		reset_cycle(walk);
+	}
+	// Tracked walks start counting at the canonical point.
+	if (tracked)
+	{
+		c[walk] = curC[walk];
+		d[walk] = curD[walk];
+	}
+	S += T;
+	sc += tc; if (sc >= order) sc -= order;
+	sd += td; if (sd >= order) sd -= order;
+}
+
+// Moves seed stream just ahead of walk walk: the next walk starts at its current point plus T.
+// Kangaroo method restarts kangaroos, that land on the trail of their own herd, this way (its seed stream lies behind the herd).
+void rhobatch::advance_seed(int walk)
+{
+	rebase(walk);
+	S = X[walk] + T;
+	sc = c[walk] + tc; if (sc >= order) sc -= order;
+	sd = d[walk] + td; if (sd >= order) sd -= order;
+}
+
+// Advances every walk by one step.
+void rhobatch::step(void)
+{
+	int i;
+	if (negation)
+	{
+		step_classes();
+		return;
+	}
+	for (i = 0; i < walks; i++)
+	{
+		index[i] = func.select(X[i]);
+		moves[i] = func.table_index(index[i]);
+		if (tracked)
+			func.apply(index[i], curC[i], curD[i]);
+		else
+			counts[i * setCount + index[i]]++;
+		length[i]++;
+	}
+	eccOperations::add_n(X, func.get_table(), moves, walks);
+}
+
+/* Internal methods */
+
+// Advances every walk by one step over classes {X, -X}.
+// An adding step to a point, that would choose the same set, is replaced by a step with the next set: otherwise the walk
+// would come back to its class at once. All walks, that try the same number of sets, share one field division.
+void rhobatch::step_classes(void)
+{
+	int i, k, count, left;
+	lnum x;
+	for (i = 0; i < walks; i++)
+	{
+		if (escaping[i])
+		{
+			X[i].get_x(x);
+			if (x == target[i])
+				escape(i);
+		}
+		index[i] = func.select(X[i]);
+		tries[i] = 1;
+		pending[i] = i;
+	}
+	for (count = walks; count > 0; count = left)
+	{
+		for (k = 0; k < count; k++)
+		{
+			Y[k] = X[pending[k]];
+			next[k] = func.table_index(index[pending[k]]);
+		}
+		eccOperations::add_n(Y, func.get_table(), next, count);
+		left = 0;
+		for (k = 0; k < count; k++)
+		{
+			i = pending[k];
+			negated[k] = canonize(Y[k], powers[k]);
+			if (next[k] >= 0 && func.select(Y[k]) == index[i] && tries[i] < setCount)
+			{
+				index[i] = (index[i] + 1) % setCount;
+				tries[i]++;
+				pending[left++] = i;
+				continue;
+			}
+			X[i] = Y[k];
+			if (tracked)
+				func.apply(index[i], curC[i], curD[i]);
+			else
+				counts[i * setCount + index[i]] += signs[i];
+			apply_class(i, powers[k], negated[k]);
+			length[i]++;
+			check_cycle(i);
+		}
+	}
+}
+
+// Replaces point by the representative of its class. Saves the Frobenius power applied to power, returns true if the point was negated.
+bool rhobatch::canonize(epoint &point, int &power) const
+{
+	bool negatedPoint;
+	if (!frobenius)
+	{
+		power = 0;
+		return point.canonize();
+	}
+	eccOperations::frobenius_canonize(point, power, negatedPoint);
+	return negatedPoint;
+}
+
+// Accounts canonization of the current point of walk walk, which applied Frobenius map power times and negated the point if negate is set.
+void rhobatch::apply_class(int walk, int power, bool negate)
+{
+	if (!tracked)
+	{
+		if (negate) signs[walk] = -signs[walk];
+		return;
+	}
+	if (power != 0)
+	{
+		curC[walk] = (curC[walk] * lambdaPowers[power]) % order;
+		curD[walk] = (curD[walk] * lambdaPowers[power]) % order;
+	}
+	if (negate)
+	{
+		if (!curC[walk].is_zero()) curC[walk] = order - curC[walk];
+		if (!curD[walk].is_zero()) curD[walk] = order - curD[walk];
+	}
+}
+
+// Applies counted steps and sign of walk walk to its coefficients, so they belong to the current point.
+void rhobatch::rebase(int walk)
+{
+	if (tracked)
+	{
+		c[walk] = curC[walk];
+		d[walk] = curD[walk];
+		return;
+	}
+	func.apply_counts(counts + walk * setCount, c[walk], d[walk]);
+	if (negation && signs[walk] < 0)
+	{
+		if (!c[walk].is_zero()) c[walk] = order - c[walk];
+		if (!d[walk].is_zero()) d[walk] = order - d[walk];
+		signs[walk] = 1;
+	}
+}
+
+// Leaves a fruitless cycle of walk walk: the walk is at the least point of the cycle, which is doubled.
+// Every walk trapped in the cycle leaves it the same way. Counting restarts from the doubled point.
+void rhobatch::escape(int walk)
+{
+	rebase(walk);
+	X[walk] += X[walk];
+	c[walk] += c[walk]; if (c[walk] >= order) c[walk] -= order;
+	d[walk] += d[walk]; if (d[walk] >= order) d[walk] -= order;
+	length[walk] = 0;
+	curC[walk] = c[walk];
+	curD[walk] = d[walk];
+	int power;
+	bool negatedPoint = canonize(X[walk], power);
+	apply_class(walk, power, negatedPoint);
+	if (tracked)
+	{
+		c[walk] = curC[walk];
+		d[walk] = curD[walk];
+	}
+	reset_cycle(walk);
+}
+
+// Remembers the current point of walk walk to find fruitless cycles from here.
+void rhobatch::reset_cycle(int walk)
+{
+	X[walk].get_x(mark[walk]);
+	least[walk] = mark[walk];
+	age[walk] = 0;
+	escaping[walk] = false;
+}
+
+// Checks, whether walk walk came back to its remembered point. Then it is in a fruitless cycle, all points of which
+// were visited since, so the least of them is known. The mark moves every POLLARD_CYCLE_WINDOW steps.
+void rhobatch::check_cycle(int walk)
+{
+	lnum x;
+	X[walk].get_x(x);
+	if (x == mark[walk])
+	{
+		escaping[walk] = true;
+		target[walk] = least[walk];
+		return;
+	}
+	if (x < least[walk]) least[walk] = x;
+	if (++age[walk] >= POLLARD_CYCLE_WINDOW)
+	{
+		mark[walk] = x;
+		least[walk] = x;
+		age[walk] = 0;
+	}
+}
@@ -0,0 +1,95 @@
+#ifndef _RHOBATCH_H
+#define _RHOBATCH_H
+
+#include "../ecc/2n.h"
+#include "../ecc/epoint.h"
+#include "../ecc/bint.h"
+
+/* Need some classes */
+class iterfunc;
+
+// Batch of walks of an iteration function (see iterfunc), advanced in lock-step.
+// All walks of a step share one field division. Coefficients are not updated while walking an additive function: every walk counts
+// its steps per set, and they are applied on request (e.g. at distinguished points). Walks with doubling sets track coefficients.
+// New walks start from a seed stream S, S + T, S + 2 * T, ..., so restarting a walk costs a single addition.
+// With negation map walks go over classes {X, -X}, always keeping the canonical point (see epoint::canonize), which takes
+// about sqrt(2) times fewer steps. A step, that would choose the same set again, takes the next set instead (look-ahead),
+// so fruitless 2-cycles never start, and longer fruitless cycles are left by doubling their least point.
+// On Koblitz curves classes may be extended to {+-tau^i(X)} (see set_frobenius), which takes about sqrt(m) times fewer steps more.
+// Frobenius map multiplies coefficients by a power of its eigenvalue, so they are tracked on every step then.
+class rhobatch
+{
+public:
+	/* Constructors */
+	rhobatch(const iterfunc &func, int walks, bool negation = false);
+
+	/* Destructors */
+	~rhobatch();
+
+	/* Accessor methods */
+	int get_walks(void) const;
+	const epoint &get_point(int walk) const;
+	int get_length(int walk) const;
+	void get_coefficients(int walk, bint &c, bint &d);
+	void get_start(int walk, bint &c, bint &d) const;
+
+	/* Walk methods */
+	void set_frobenius(const bint &lambda);
+	void set_seed(const epoint &S, const bint &sc, const bint &sd, const epoint &T, const bint &tc, const bint &td);
+	void restart(int walk);
+	void advance_seed(int walk);
+	void step(void);
+
+private:
+	rhobatch(const rhobatch &batch);
+	void operator= (const rhobatch &batch);
+
+	/* Internal methods */
+	void step_classes(void);
+	bool canonize(epoint &point, int &power) const;
+	void apply_class(int walk, int power, bool negate);
+	void rebase(int walk);
+	void escape(int walk);
+	void reset_cycle(int walk);
+	void check_cycle(int walk);
+
+	const iterfunc &func;
+	int setCount;
+	bint order;
+
+	int walks;
+	epoint *X;     // current points
+	bint *c;       // coefficients of the point, where counting started
+	bint *d;
+	int *counts;   // walks * setCount step counters
+	int *length;   // steps since counting started
+	int *index;    // sets chosen by the current step
+	int *moves;    // table indices of the current step (see iterfunc::table_index)
+	bool tracked;  // coefficients are updated on every step (doubling sets or Frobenius classes)
+	bint *curC;    // coefficients of the current points, when tracked
+	bint *curD;
+
+	// Negation map
+	bool negation;
+	int *signs;    // current point is signs * (c * P + d * Q + counted steps)
+	int *tries;    // sets tried by the current step
+	int *pending;  // walks, whose step is not chosen yet
+	int *next;     // sets tried by pending walks
+	epoint *Y;     // points tried by pending walks
+	lnum *mark;    // x of the point remembered to find fruitless cycles
+	lnum *least;   // least x since the mark
+	lnum *target;  // least x of the found cycle
+	int *age;      // steps since the mark
+	bool *escaping;
+	int *powers;   // Frobenius powers, that canonize points tried by pending walks
+	bool *negated; // whether points tried by pending walks are negated by canonization
+
+	// Frobenius classes
+	int frobenius;       // field degree, when walks go over classes {+-tau^i(X)} (0 - otherwise)
+	bint *lambdaPowers;  // powers of Frobenius eigenvalue modulo order
+
+	// Seed stream
+	epoint S, T;
+	bint sc, sd, tc, td;
+};
+#endif
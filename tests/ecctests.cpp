@@ -0,0 +1,106 @@
+// Tests of ECC library. Build with all ECC sources except main.cpp; exit code is the number of failed checks.
+
+#include <iostream>
+#include <sstream>
+#include "../ECC/2n.h"
+#include "../ECC/2nfactory.h"
+#include "../ECC/bint.h"
+#include "../ECC/ecurve.h"
+#include "../ECC/epoint.h"
+#include "../ECC/eccoperations.h"
+#include "../ECC/helpers.h"
+#include "../ECC/prng.h"
+
+int failures = 0;
+
+// Reports failed check name.
+void check(bool condition, const char *name)
+{
+	if (condition) return;
+	std::cout << "[-] " << name << std::endl;
+	failures++;
+}
+
+// Packed K-163 point (x with the solution bit at bit 163) decodes to the same y as in earlier versions, single and batched.
+void test_packed_point(void)
+{
+	std::istringstream f("0 3 6 7 163\nx1\nx1\n0\n");
+	gf2n *field = helpers::read_field(f);
+	ecurve *curve = helpers::read_curve(f, *field);
+	lnum x((char *)"xAD0592F9 3220B731 C3C24D41 5367F2BB 1E466D8E 40000000", *field);
+	lnum y[2] = {
+		lnum((char *)"xACCFEB57 E3E16895 78F5C153 7AC5FBE1 7BB79F03 60000000", *field),
+		lnum((char *)"x01CA79AE D1C1DFA4 BB378C12 29A2095A 65F1F28D 20000000", *field)
+	};
+	lnum packed[2] = {x, x};
+	packed[1].set_bit(163);
+
+	epoint points[2], batch[2];
+	lnum repacked(*field);
+	for (int i = 0; i < 2; i++)
+	{
+		check(curve->unpack(packed[i], points[i]) == pE_OK, "unpack");
+		check(points[i].get_x() == x && points[i].get_y() == y[i], "unpack: known point");
+		check(points[i].pack(repacked) == pE_OK && repacked == packed[i], "pack: known value");
+	}
+	check(curve->unpack_n(packed, 2, batch) == pE_OK, "unpack_n");
+	check(batch[0] == points[0] && batch[1] == points[1], "unpack_n: known points");
+	delete curve;
+	delete field;
+}
+
+// read_curve selects halve-and-add on B-163 (not a Koblitz curve) given its factorization, and it agrees with double-and-add.
+void test_halving_selection(void)
+{
+	std::istringstream f("0 3 6 7 163\nx1\nxDF5023A44787F21501BE1841AC359C8B709106A02\n2\n2 1\n5846006549323611672814742442876390689256843201587 1\n");
+	gf2n *field = helpers::read_field(f);
+	ecurve *curve = helpers::read_curve(f, *field);
+	check(curve->get_mul_method() == pMulHalving, "read_curve: halving selected");
+
+	epoint P = curve->random_point();
+	P += P;
+	bint k((char *)"4567890123456789012345678901234567890123456789");
+	epoint halved(*curve), doubled(*curve);
+	eccOperations::mul(P, k, halved);
+	curve->set_mul_method(pMulDoubling);
+	eccOperations::mul(P, k, doubled);
+	check(halved == doubled, "halving: same product");
+	delete curve;
+	delete field;
+}
+
+// Division keeps trailing zero digit groups of the quotient (1000000 / 2 was 50) and agrees with the remainder.
+void test_bint_division(void)
+{
+	check(bint(1000000) / bint(2) == bint(500000), "div: 1000000 / 2");
+	check(bint((char *)"100000000000000000000000000000") / bint(5) == bint((char *)"20000000000000000000000000000"), "div: 10^29 / 5");
+	check(bint((char *)"123456789000000000000000000") / bint((char *)"123456789") == bint((char *)"1000000000000000000"), "div: 10^18 quotient");
+
+	bint a, b, q, r, m(1);
+	for (int i = 0; i < 1000; i++)
+	{
+		if (i % 40 == 0) m = m * bint(1000);
+		a.random_mod(m);
+		b.random_mod(bint(1 + i % 1000));
+		b += bint(1);
+		if (i % 3 == 0) a = a * bint(100000);
+		q = a / b;
+		r = a % b;
+		if (!(q * b + r == a) || !(r < b) || r.is_less_zero())
+		{
+			check(false, "div: q * b + r == a");
+			break;
+		}
+	}
+}
+
+int main(void)
+{
+	prng::initialize(prng::default_seed());
+	test_packed_point();
+	test_halving_selection();
+	test_bint_division();
+	if (failures) std::cout << "[-] Failed checks: " << failures << std::endl;
+	else std::cout << "[+] All checks passed." << std::endl;
+	return failures;
+}
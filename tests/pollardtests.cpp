@@ -0,0 +1,229 @@
+// Tests of ECDLP solvers. Build with all ECC sources except main.cpp and all pollard sources except pollard.cpp; exit code is the number of failed checks.
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <atomic>
+#include "../ECC/2n.h"
+#include "../ECC/2nfactory.h"
+#include "../ECC/bint.h"
+#include "../ECC/cpoint.h"
+#include "../ECC/ecurve.h"
+#include "../ECC/epoint.h"
+#include "../ECC/eccoperations.h"
+#include "../ECC/helpers.h"
+#include "../ECC/prng.h"
+#include "../pollard/crack.h"
+#include "../pollard/crackdefines.h"
+#include "../pollard/dpstore.h"
+
+// Koblitz curve over GF(2^96) with fully factored order 2^7 * 3^4 * 5^2 * 7 * 37 * 113 * 32993 * 74209 * 4265677249.
+const char *testCurve = "0 6 9 10 96\nx0\nx1\n9\n4265677249 1\n32993 1\n74209 1\n2 7\n3 4\n5 2\n7 1\n37 1\n113 1\n";
+
+int failures = 0;
+
+// Reports failed check name.
+void check(bool condition, const char *name)
+{
+	if (condition) return;
+	std::cout << "[-] " << name << std::endl;
+	failures++;
+}
+
+// Reports failed check name made of prefix and details.
+void check(bool condition, const char *prefix, const std::string &details)
+{
+	check(condition, (std::string(prefix) + details).c_str());
+}
+
+// Returns a point of prime order p on curve (p must divide the curve order).
+epoint subgroup_point(const ecurve &curve, const bint &p)
+{
+	bint n;
+	curve.order(n);
+	epoint P(curve);
+	do
+		eccOperations::mul(curve.random_point(), n / p, P);
+	while (P.is_inf());
+	return P;
+}
+
+// Threads inserting the same keys into a small store get exactly one new record per key, others get that record back.
+void test_dpstore_concurrent(void)
+{
+	const int threads = 8, keys = 10000;
+	dpstore store(16);
+	std::atomic<int> inserted(0), found(0), wrong(0);
+	std::thread workers[threads];
+	for (int t = 0; t < threads; t++)
+		workers[t] = std::thread([&, t]()
+		{
+			for (int i = 0; i < keys; i++)
+			{
+				int v = (i * 7 + t * 1013) % keys;
+				cpoint key;
+				memset(&key, 0, sizeof(key));
+				key.w[0] = v;
+				key.w[1] = v * 31 + 1;
+				const dpentry *entry = store.insert(key, bint(v), bint(t), i);
+				if (entry == 0)
+					inserted++;
+				else
+				{
+					found++;
+					if (!(entry->key == key) || !(entry->c == bint(v))) wrong++;
+				}
+			}
+		});
+	for (int t = 0; t < threads; t++)
+		workers[t].join();
+	check(inserted == keys && store.get_count() == keys, "dpstore: one record per key");
+	check(found == (threads - 1) * keys && wrong == 0, "dpstore: others get the stored record");
+	store.clear();
+	check(store.get_count() == 0, "dpstore: clear");
+}
+
+// Rho-method solves ECDLP in prime-order subgroups in every search mode, with and without negation map.
+void test_pollard_modes(const ecurve &curve)
+{
+	const int modes[] = { POLLARD_SEARCH_FLOYD, POLLARD_SEARCH_BATCH, POLLARD_SEARCH_DP, POLLARD_SEARCH_BRENT };
+	const char *names[] = { "Floyd", "batch", "DP", "Brent" };
+	const char *orders[] = { "32993", "74209" };
+	int searchMode = crack::get_search_mode(), budget = crack::get_bsgs_budget();
+	bool negation = crack::get_negation_map();
+	// Tiny budget keeps baby-step giant-step method out of small groups.
+	crack::set_bsgs_budget(1);
+
+	for (int i = 0; i < 2; i++)
+	{
+		bint p((char *)orders[i]);
+		epoint P = subgroup_point(curve, p);
+		for (int m = 0; m < 4; m++)
+			for (int n = 0; n < 2; n++)
+			{
+				crack::set_search_mode(modes[m]);
+				crack::set_negation_map(n != 0);
+				bint k, r;
+				k.random_mod(p);
+				epoint Q(curve);
+				eccOperations::mul(P, k, Q);
+				int iterations;
+				double work_time;
+				bool solved = crack::pollard(P, Q, p, r, iterations, work_time);
+				std::ostringstream details;
+				details << names[m] << ", p = " << orders[i] << (n ? ", negation map" : "");
+				check(solved && r == k, "pollard: ", details.str());
+			}
+	}
+
+	crack::set_search_mode(searchMode);
+	crack::set_negation_map(negation);
+	crack::set_bsgs_budget(budget);
+}
+
+// Kangaroo method finds solutions at both ends and inside of an interval.
+void test_kangaroo(const ecurve &curve)
+{
+	bint p((char *)"4265677249");
+	epoint P = subgroup_point(curve, p);
+	bint lo, width(1 << 24);
+	lo.random_mod(p - width);
+	bint hi = lo + width - bint(1);
+	bint keys[3];
+	keys[0] = lo;
+	keys[1] = hi;
+	keys[2].random_mod(width);
+	keys[2] += lo;
+	for (int i = 0; i < 3; i++)
+	{
+		epoint Q(curve);
+		eccOperations::mul(P, keys[i], Q);
+		bint r;
+		int iterations;
+		double work_time;
+		bool solved = crack::kangaroo(P, Q, p, lo, hi, r, iterations, work_time);
+		check(solved && r == keys[i], i == 0 ? "kangaroo: lower end" : i == 1 ? "kangaroo: upper end" : "kangaroo: inside");
+	}
+}
+
+// Baby-step giant-step method solves ECDLP in prime-order subgroups.
+void test_bsgs(const ecurve &curve)
+{
+	const char *orders[] = { "113", "74209", "4265677249" };
+	for (int i = 0; i < 3; i++)
+	{
+		bint p((char *)orders[i]);
+		epoint P = subgroup_point(curve, p);
+		bint keys[3];
+		keys[0] = bint(1);
+		keys[1] = p - bint(1);
+		keys[2].random_mod(p);
+		for (int j = 0; j < 3; j++)
+		{
+			epoint Q(curve);
+			eccOperations::mul(P, keys[j], Q);
+			bint r;
+			int iterations;
+			double work_time;
+			bool solved = crack::bsgs(P, Q, p, r, iterations, work_time);
+			check(solved && r == keys[j], "bsgs: p = ", orders[i]);
+		}
+	}
+}
+
+// Reconstruction plan over the curve order factorization returns the number, residues were taken from (singly and in batch).
+void test_crtplan(const ecurve &curve)
+{
+	int i, j, n = curve.get_factor_length();
+	const bfactor *factors = curve.get_factor();
+	bint N;
+	curve.order(N);
+	pofactor *moduli = new pofactor[n];
+	for (i = 0; i < n; i++)
+	{
+		moduli[i].p = factors[i].p;
+		moduli[i].k = factors[i].k;
+	}
+	crtplan plan(moduli, n, N);
+	check(plan.get_count() == n, "crtplan: count");
+
+	const int count = 4;
+	bint x[count], results[count];
+	bint *residues = new bint[count * n];
+	for (j = 0; j < count; j++)
+	{
+		x[j].random_mod(N);
+		if (j == 0) x[j].zero();
+		if (j == 1) x[j] = N - bint(1);
+		for (i = 0; i < n; i++)
+			residues[j * n + i] = x[j] % plan.get_modulus(i);
+	}
+	for (i = 0; i < n; i++)
+		moduli[i].sol = residues[2 * n + i];
+	check(plan.reconstruct(moduli) == x[2], "crtplan: factors");
+	check(plan.reconstruct(residues + n) == x[1], "crtplan: residues");
+	plan.reconstruct(residues, count, results);
+	for (j = 0; j < count; j++)
+		check(results[j] == x[j], "crtplan: batch");
+	delete[] residues;
+	delete[] moduli;
+}
+
+int main(void)
+{
+	prng::initialize(prng::default_seed());
+	std::istringstream f(testCurve);
+	gf2n *field = helpers::read_field(f);
+	ecurve *curve = helpers::read_curve(f, *field);
+	test_dpstore_concurrent();
+	test_pollard_modes(*curve);
+	test_kangaroo(*curve);
+	test_bsgs(*curve);
+	test_crtplan(*curve);
+	delete curve;
+	delete field;
+	if (failures) std::cout << "[-] Failed checks: " << failures << std::endl;
+	else std::cout << "[+] All checks passed." << std::endl;
+	return failures;
+}